@@ -2,12 +2,22 @@
 SCRIPTDIR="$(cd "$(dirname "$0")" && pwd)"
 cd "$SCRIPTDIR"
 
-declare -a commands=('testmitchellmoore' 'testmersennetwister' 'testxorshift-k4' 'testxorshift-k5' 'testwidynski' 'testaesctr' 'testxorshift128plus -H' 'testxorshift128plus' 'testxoroshiro128plus -H' 'testxoroshiro128plus' 'testpcg32' 'testpcg64 -H' 'testpcg64' 'testsplitmix64 -H' 'testsplitmix64' 'testxorshift32' );
+# every generator of the registry (./rngstream --list), or only those named
+# on the command line; each 64-bit generator twice: as 64-bit words, and
+# as their most significant 32 bits (-H)
+declare -a commands=()
+while read -r gen bits; do
+  if [ $# -gt 0 ] && [[ ! " $* " =~ " $gen " ]]; then
+    continue
+  fi
+  commands+=("$gen")
+  if [ "$bits" == "64" ]; then
+    commands+=("$gen -H")
+  fi
+done < <(./rngstream --list)
 for t in "${commands[@]}"; do
-     ./$t | dd of=scratchfile bs=1024 count=1024 > out.log 2> err.log
+     ./rngstream --gen $t --bytes 1M > scratchfile
      echo -n $t " : "
      ./ent scratchfile | grep Entropy
 done
 rm scratchfile
-rm err.log
-rm out.log
@@ -1 +1 @@
-file(ARCHIVE_EXTRACT INPUT ../../practrand/PractRand_0.93.zip DESTINATION build)
\ No newline at end of file
+file(ARCHIVE_EXTRACT INPUT ${PRACTRAND_ARCHIVE} DESTINATION . PATTERNS "PractRand/*")
\ No newline at end of file
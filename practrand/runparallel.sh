@@ -0,0 +1,188 @@
+#!/usr/bin/env bash
+# Runs the tests of runtests.sh concurrently (needs bash 5.1 for wait -p).
+# Each job is one rngtest process, pinned to a core of its own. A job
+# starts once a core is free and the memory budget has room for it:
+# RNG_test needs more memory the longer it runs, so each job reserves an
+# estimate that grows with -tlmax (--job-mem sets it). The slowest
+# generators, which take longest for the same length, start first. A
+# job stops at its first report with a result as bad as --stop-at (FAIL by
+# default), and writes each result of each report to testNAME.tsv.
+# runparallel-status.txt lists every job, and is rewritten whenever one
+# finishes.
+if (( BASH_VERSINFO[0] < 5 || (BASH_VERSINFO[0] == 5 && BASH_VERSINFO[1] < 1) )); then
+  echo "$0 needs bash 5.1 or later (for wait -p); this is bash $BASH_VERSION." >&2
+  exit 1
+fi
+SCRIPTDIR="$(cd "$(dirname "$0")" && pwd)"
+cd "$SCRIPTDIR"
+
+usage() {
+  echo "Usage: $0 [-j CORES] [-m MEMORY_MB] [--job-mem MB] [-t LENGTH]"
+  echo "       [--stop-at VERDICT] [GENERATOR...]"
+  echo " -j CORES       jobs at once (default: the cores we may run on)"
+  echo " -m MEMORY_MB   memory for all jobs (default: 90% of MemAvailable)"
+  echo " --job-mem MB   memory of one job (default: estimated from LENGTH)"
+  echo " -t LENGTH      bytes per job, as for RNG_test -tlmax (default: 512GB)"
+  echo " --stop-at VERDICT  stop a job at this verdict, as for rngtest (default: FAIL)"
+  echo "The generators are those of ./rngstream --list, or those named."
+}
+
+MEM="512GB"
+CORES=""
+MEMORY_MB=""
+JOB_MEM_MB=""
+STOP_AT="FAIL"
+while [ $# -gt 0 ]; do
+  case "$1" in
+    -j) CORES=$2; shift 2 ;;
+    -m) MEMORY_MB=$2; shift 2 ;;
+    --job-mem) JOB_MEM_MB=$2; shift 2 ;;
+    -t) MEM=$2; shift 2 ;;
+    --stop-at) STOP_AT=$2; shift 2 ;;
+    -h|--help) usage; exit 0 ;;
+    -*) usage; exit 1 ;;
+    *) break ;;
+  esac
+done
+. ./testlist.sh
+
+# the CPUs we may run on: "0-3,8" is 0 1 2 3 8
+cpulist() {
+  local IFS=, r
+  for r in $1; do
+    if [[ $r == *-* ]]; then seq "${r%-*}" "${r#*-}"; else echo "$r"; fi
+  done
+}
+declare -a cpus=($(cpulist "$(awk '/^Cpus_allowed_list/ {print $2}' /proc/self/status 2>/dev/null)"))
+if [ ${#cpus[@]} -eq 0 ]; then
+  cpus=($(seq 0 $(( $(getconf _NPROCESSORS_ONLN) - 1 ))))
+fi
+CORES=${CORES:-${#cpus[@]}}
+if ! [[ $CORES =~ ^[0-9]+$ ]] || [ "$CORES" -eq 0 ]; then
+  echo "-j takes a positive number of jobs, not '$CORES'." >&2
+  exit 1
+fi
+# each job has a CPU of its own
+if [ "$CORES" -gt ${#cpus[@]} ]; then
+  echo "Only ${#cpus[@]} CPUs to run on: running ${#cpus[@]} jobs at once, not $CORES." >&2
+  CORES=${#cpus[@]}
+fi
+PIN=""
+command -v taskset > /dev/null && PIN=1
+
+if [ -z "$MEMORY_MB" ]; then
+  MEMORY_MB=$(awk '/^MemAvailable/ {print int($2 * 0.9 / 1024)}' /proc/meminfo 2>/dev/null)
+  MEMORY_MB=${MEMORY_MB:-4096}
+fi
+# 512GB, 1TB, ... in megabytes
+length_mb() {
+  local n=${1%%[!0-9]*} u=${1##*[0-9]}
+  case ${u^^} in
+    KB) echo $(( n / 1024 )) ;;
+    MB) echo $(( n )) ;;
+    GB) echo $(( n * 1024 )) ;;
+    TB) echo $(( n * 1024 * 1024 )) ;;
+    *) echo $(( n / 1048576 )) ;;
+  esac
+}
+# RNG_test peaks near 130 MB at 64 MB, 300 MB at 2 GB: we reserve 192 MB,
+# and 96 MB more per doubling of the length beyond 1 GB
+if [ -z "$JOB_MEM_MB" ]; then
+  JOB_MEM_MB=192
+  for (( l = 1024; l < $(length_mb $MEM); l *= 2 )); do
+    JOB_MEM_MB=$(( JOB_MEM_MB + 96 ))
+  done
+fi
+echo "Testing $MEM of data per run, ${#commands[@]} runs, $CORES at once," \
+     "$JOB_MEM_MB MB each out of $MEMORY_MB MB"
+
+# At equal lengths, a job takes longer the slower its generator: we time
+# 256 MB of each and start the slowest first.
+declare -A rate
+for t in "${commands[@]}"; do
+  r=$(./rngstream --gen $t --bytes 256M --report 2>&1 > /dev/null | sed -n 's/.* \([0-9.]*\) GB\/s.*/\1/p')
+  rate[$t]=${r:-0}
+done
+mapfile -t queue < <(for t in "${commands[@]}"; do echo "${rate[$t]} $t"; done | sort -g | cut -d' ' -f2-)
+
+declare -A state cpu start elapsed
+declare -A pid_command
+for t in "${queue[@]}"; do state[$t]="queued"; done
+declare -a free=()
+for (( i = 0; i < CORES; i++ )); do free+=("${cpus[i]}"); done
+reserved=0
+
+logname() {
+  echo "test$1.log" | sed 's/ //g'
+}
+
+recordname() {
+  echo "test$1.tsv" | sed 's/ //g'
+}
+
+hms() {
+  printf "%d:%02d:%02d" $(( $1 / 3600 )) $(( $1 / 60 % 60 )) $(( $1 % 60 ))
+}
+
+write_status() {
+  {
+    printf "%-28s %-8s %4s %10s  %-22s %s\n" "generator" "state" "cpu" "time" "length" "first failure"
+    local t len fail
+    for t in "${queue[@]}"; do
+      len="" fail=""
+      if [ "${state[$t]}" != "queued" ]; then
+        len=$(grep 'length=' "$(logname "$t")" 2>/dev/null | tail -1 | sed 's/.*length= *\([^(]*[^ (]\) *(.*/\1/')
+        fail=$(grep -m1 'FAIL' "$(logname "$t")" 2>/dev/null | sed 's/^ *//; s/  */ /g')
+      fi
+      printf "%-28s %-8s %4s %10s  %-22s %s\n" "$t" "${state[$t]}" "${cpu[$t]}" \
+        "${elapsed[$t]}" "$len" "$fail"
+    done
+  } > runparallel-status.txt
+}
+
+trap 'kill ${!pid_command[@]} 2> /dev/null; write_status; exit 1' INT TERM
+
+next=0
+write_status
+while [ $next -lt ${#queue[@]} ] || [ ${#pid_command[@]} -gt 0 ]; do
+  # as many jobs as the cores and the memory allow, and at least one
+  while [ $next -lt ${#queue[@]} ] && [ ${#free[@]} -gt 0 ] &&
+        { [ $(( reserved + JOB_MEM_MB )) -le $MEMORY_MB ] || [ ${#pid_command[@]} -eq 0 ]; }; do
+    t=${queue[$next]}
+    next=$(( next + 1 ))
+    cpu[$t]=${free[0]}
+    free=("${free[@]:1}")
+    if [ -n "$PIN" ]; then
+      taskset -c ${cpu[$t]} ./rngtest --gen $t -tlmax $MEM --stop-at "$STOP_AT" \
+        --records "$(recordname "$t")" > "$(logname "$t")" &
+    else
+      ./rngtest --gen $t -tlmax $MEM --stop-at "$STOP_AT" \
+        --records "$(recordname "$t")" > "$(logname "$t")" &
+    fi
+    pid_command[$!]=$t
+    state[$t]="running"
+    start[$t]=$SECONDS
+    reserved=$(( reserved + JOB_MEM_MB ))
+    echo "# RUNNING $t on cpu ${cpu[$t]}, outputting result to $(logname "$t")"
+  done
+  write_status
+  wait -n -p finished
+  status=$?
+  t=${pid_command[$finished]}
+  unset "pid_command[$finished]"
+  free+=("${cpu[$t]}")
+  reserved=$(( reserved - JOB_MEM_MB ))
+  elapsed[$t]=$(hms $(( SECONDS - start[$t] )))
+  if grep -q "FAIL" "$(logname "$t")"; then
+    state[$t]="FAIL"
+  elif grep -q "^Stopped:" "$(logname "$t")"; then
+    state[$t]="stopped"
+  elif [ $status -ne 0 ]; then
+    state[$t]="error"
+  else
+    state[$t]="pass"
+  fi
+  echo "# $t: ${state[$t]} after ${elapsed[$t]}"
+  write_status
+done
+cat runparallel-status.txt
@@ -5,22 +5,19 @@ cd "$SCRIPTDIR"
 MEM="512GB"
 RED='\033[0;31m'
 GREEN='\033[0;32m'
-YELLOW='\033[0;33m'
 NC='\033[0m' # No Color
 echo "Testing "$MEM " of data per run"
 echo "Note: running the tests longer could expose new failures."
 
-declare -a commands=('testmitchellmoore' 'testmersennetwister' 'testxorshift-k4' 'testxorshift-k5' 'testwidynski' 'testaesctr' 'testaesdragontamer'  'testv8xorshift128plus -H' 'testv8xorshift128plus' 'testxorshift128plus -H' 'testxorshift128plus' 'testxoroshiro128plus -H' 'testxoroshiro128plus' 'testpcg32' 'testpcg64 -H' 'testpcg64' 'testsplitmix64 -H' 'testsplitmix64' 'testxorshift32'  'testxorshift1024star' 'testxorshift1024star -H'  'testxorshift1024plus' 'testxorshift1024plus -H' 'testwyhash' 'testwyhash -H' 'testwyrand' 'testwyrand -H' 'testw1rand' 'testw1rand -H');
+. ./testlist.sh
 for t in "${commands[@]}"; do
-     exe=$(echo $t | awk '{print $1}')
-     if [ ! -x "./$exe" ]; then
-       echo -e "${YELLOW}# SKIPPING $t (executable not found)${NC}"
-       continue
-     fi
-     wf=$(echo $t | sed 's/ //g')
+     wf=$(echo test$t | sed 's/ //g')
      filelog=$wf.log
      echo "# RUNNING" $t  "Outputting result to " $filelog
-    ./$t | ./RNG_test stdin64 -tlmax $MEM > $filelog
+    # same results as ./rngstream --gen $t | ./RNG_test stdin64, without the
+    # pipe, reported from 1 MB on, stopping at the first FAIL; each result
+    # of each report goes to $wf.tsv
+    ./rngtest --gen $t -tlmax $MEM --stop-at FAIL --records $wf.tsv > $filelog
     grep -s "FAIL" $filelog > /dev/null
     RESULT=$?
     if [ $RESULT == 1 ]; then
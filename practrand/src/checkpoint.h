@@ -0,0 +1,107 @@
+#ifndef PRACTRAND_CHECKPOINT_H
+#define PRACTRAND_CHECKPOINT_H
+
+// The checkpoints of rngstream and rngtest: where a stream stands, so that
+// a run that was stopped can go on with the same bytes. A small text file:
+//   impl pcg64
+//   seed 12345678
+//   half H          (or L, or - for the values as they are)
+//   offset 1099511627776
+//   state 0123...   (the state of the generator, in hexadecimal)
+// The state is the one that produces the byte at offset. It is written to
+// FILE.tmp, which then replaces FILE: a kill leaves the last one whole.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "rnginfo.h"
+
+// seconds between two checkpoints of a run
+#define checkpoint_seconds 60
+
+typedef struct {
+  uint64_t seed;
+  int half; // 0, 'H' or 'L'
+  uint64_t offset; // bytes of the stream before the state
+} stream_checkpoint;
+
+static inline int save_stream_checkpoint(const char *filename,
+                                         const rng_info *info,
+                                         const stream_checkpoint *ck,
+                                         const void *state) {
+  char *tmpname = (char *)malloc(strlen(filename) + 5);
+  if (tmpname == NULL) return 0;
+  sprintf(tmpname, "%s.tmp", filename);
+  FILE *f = fopen(tmpname, "w");
+  if (f == NULL) {
+    perror(tmpname);
+    free(tmpname);
+    return 0;
+  }
+  fprintf(f, "impl %s\n", info->impl);
+  fprintf(f, "seed %llu\n", (unsigned long long)ck->seed);
+  fprintf(f, "half %c\n", ck->half != 0 ? ck->half : '-');
+  fprintf(f, "offset %llu\n", (unsigned long long)ck->offset);
+  fprintf(f, "state ");
+  for (size_t i = 0; i < info->state_size; i++)
+    fprintf(f, "%02x", ((const unsigned char *)state)[i]);
+  fprintf(f, "\n");
+  int ok = fflush(f) == 0 && fsync(fileno(f)) == 0;
+  ok = (fclose(f) == 0) && ok && rename(tmpname, filename) == 0;
+  if (!ok) perror(filename);
+  free(tmpname);
+  return ok;
+}
+
+// Fills ck and the state of info; 0 if the file is damaged or is of another
+// implementation (whose state may not even have the same size).
+static inline int load_stream_checkpoint(const char *filename,
+                                         const rng_info *info,
+                                         stream_checkpoint *ck, void *state) {
+  FILE *f = fopen(filename, "r");
+  if (f == NULL) return 0;
+  size_t linesize = 2 * info->state_size + 64;
+  char *line = (char *)malloc(linesize);
+  if (line == NULL) {
+    fclose(f);
+    return 0;
+  }
+  int same_impl = 0, have_seed = 0, have_half = 0, have_offset = 0,
+      have_state = 0, ok = 1;
+  unsigned long long number;
+  memset(ck, 0, sizeof(*ck));
+  while (ok && fgets(line, (int)linesize, f) != NULL) {
+    char *value = strchr(line, ' ');
+    if (value == NULL) continue;
+    *value++ = '\0';
+    value[strcspn(value, "\n")] = '\0';
+    if (!strcmp(line, "impl")) {
+      ok = same_impl = !strcmp(value, info->impl);
+    } else if (!strcmp(line, "seed")) {
+      ok = have_seed = sscanf(value, "%llu", &number) == 1;
+      ck->seed = number;
+    } else if (!strcmp(line, "half")) {
+      ok = have_half = !strcmp(value, "H") || !strcmp(value, "L") ||
+                       !strcmp(value, "-");
+      ck->half = value[0] == '-' ? 0 : value[0];
+    } else if (!strcmp(line, "offset")) {
+      ok = have_offset = sscanf(value, "%llu", &number) == 1;
+      ck->offset = number;
+    } else if (!strcmp(line, "state") && same_impl) {
+      ok = have_state = strlen(value) == 2 * info->state_size;
+      for (size_t i = 0; ok && i < info->state_size; i++) {
+        unsigned int byte;
+        ok = sscanf(value + 2 * i, "%2x", &byte) == 1;
+        ((unsigned char *)state)[i] = (unsigned char)byte;
+      }
+    }
+  }
+  free(line);
+  fclose(f);
+  return ok && same_impl && have_seed && have_half && have_offset && have_state;
+}
+
+#endif // PRACTRAND_CHECKPOINT_H
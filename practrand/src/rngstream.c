@@ -0,0 +1,332 @@
+#define _GNU_SOURCE // vmsplice, F_SETPIPE_SZ
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <getopt.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/uio.h>
+#endif
+
+#include "checkpoint.h"
+#include "registry.h"
+
+// Writes the output of one generator of the registry to stdout until the
+// reader stops, for PractRand (RNG_test stdin64) and for ent:
+//   rngstream --gen pcg64        the 64-bit words, as they are
+//   rngstream --gen pcg64 -H     the most significant 32 bits of each word
+//   rngstream --gen wyrand -L    the least significant 32 bits of each word
+//   rngstream --list             every generator, with its width in bits
+//
+// The output goes out in large page-aligned blocks. With --vmsplice, when
+// stdout is a pipe (on Linux), vmsplice hands the pages of a block to the
+// pipe instead of copying them into it, and the generator fills the next
+// block meanwhile. The pages are not gifted: we refill them once the pipe
+// cannot hold them any more, which is safe for a reader that reads the
+// pipe, but not for one that splices or tees it (pv without -C, tee), whose
+// copies would still point at our pages and change under it.
+//
+// With --checkpoint FILE, the state of the generator and the number of
+// bytes written go to FILE (see checkpoint.h) every minute, and when the
+// reader stops; --resume goes on from there, with the same options.
+
+#define default_block (1u << 20)
+
+static void printusage(const char *command) {
+  printf("Usage: %s --gen NAME [-H | -L] [-S SEED] [--bytes N] [--block N]\n"
+         "       [--vmsplice] [--report] [--checkpoint FILE [--resume]]\n", command);
+  printf("       %s --list\n", command);
+  printf(" --gen NAME     the generator (see --list), or one implementation of it\n");
+  printf(" -H             the most significant 32 bits of each 64-bit word\n");
+  printf(" -L             the least significant 32 bits of each 64-bit word\n");
+  printf(" -S SEED        the seed (default: 12345678)\n");
+  printf(" --bytes N      stop after N bytes (e.g. 1M, 512G; default: never)\n");
+  printf(" --block N      bytes per write, rounded up to whole pages (default: 1M)\n");
+  printf(" --vmsplice     move the blocks into a pipe with vmsplice, not write\n"
+         "                (only for readers that read the pipe: not splice or tee)\n");
+  printf(" --report       print the throughput to stderr when done\n");
+  printf(" --checkpoint F save the state and the offset of the stream to F\n");
+  printf(" --resume       go on from the checkpoint, with the same options\n"
+         "                (--bytes still counts from the start of the stream)\n");
+  printf(" --list         list the generators, one per line, with their width\n");
+}
+
+// one line per stream: its name and its width in bits
+static void printlist(void) {
+  for (size_t i = 0; i < RNG_REGISTRY_SIZE; i++) {
+    const rng_info *info = rng_find(rng_registry[i].name);
+    if (info == &rng_registry[i]) printf("%s %u\n", info->name, info->bits);
+  }
+}
+
+// a number of bytes, with an optional K, M, G or T suffix (powers of 1024)
+// and an optional B: 1M, 512GB; 0 if it cannot be parsed
+static uint64_t parsebytes(const char *s) {
+  char *end;
+  uint64_t n = strtoull(s, &end, 10);
+  switch (*end) {
+  case 'T': case 't': n <<= 10; // fall through
+  case 'G': case 'g': n <<= 10; // fall through
+  case 'M': case 'm': n <<= 10; // fall through
+  case 'K': case 'k': n <<= 10; end++; break;
+  default: break;
+  }
+  if (*end == 'B' || *end == 'b') end++;
+  return (end == s || *end != '\0') ? 0 : n;
+}
+
+// The next `bytes` bytes of the stream (a multiple of 4096): the values as
+// they are, or the chosen half of each 64-bit value.
+static void fill_block(const rng_info *info, void *state, int half,
+                       unsigned char *block, size_t bytes) {
+  if (half != 0) {
+    const int shift = (half == 'H') ? 32 : 0;
+    uint32_t *out = (uint32_t *)block;
+    uint64_t values[512];
+    for (size_t i = 0; i < bytes / sizeof(uint32_t); i += 512) {
+      info->fill(state, values, 512);
+      for (int k = 0; k < 512; k++) out[i + k] = (uint32_t)(values[k] >> shift);
+    }
+  } else {
+    info->fill(state, block, bytes * 8 / info->bits);
+  }
+}
+
+// Both return 0 once the reader is gone.
+static int write_all(int fd, const unsigned char *buf, size_t n) {
+  while (n > 0) {
+    ssize_t w = write(fd, buf, n);
+    if (w < 0) {
+      if (errno == EINTR) continue;
+      return 0;
+    }
+    buf += w;
+    n -= (size_t)w;
+  }
+  return 1;
+}
+
+#ifdef __linux__
+static int vmsplice_all(int fd, const unsigned char *buf, size_t n) {
+  while (n > 0) {
+    struct iovec iov = {(void *)buf, n};
+    ssize_t w = vmsplice(fd, &iov, 1, 0);
+    if (w < 0) {
+      if (errno == EINTR) continue;
+      return 0;
+    }
+    buf += w;
+    n -= (size_t)w;
+  }
+  return 1;
+}
+#endif
+
+int main(int argc, char **argv) {
+  enum { OPT_BYTES = 256, OPT_BLOCK, OPT_VMSPLICE, OPT_REPORT, OPT_CHECKPOINT, OPT_RESUME };
+  static const struct option long_options[] = {
+      {"gen", required_argument, NULL, 'g'},
+      {"list", no_argument, NULL, 'l'},
+      {"bytes", required_argument, NULL, OPT_BYTES},
+      {"block", required_argument, NULL, OPT_BLOCK},
+      {"vmsplice", no_argument, NULL, OPT_VMSPLICE},
+      {"report", no_argument, NULL, OPT_REPORT},
+      {"checkpoint", required_argument, NULL, OPT_CHECKPOINT},
+      {"resume", no_argument, NULL, OPT_RESUME},
+      {"help", no_argument, NULL, 'h'},
+      {NULL, 0, NULL, 0}};
+  const char *gen = NULL;
+  uint64_t seedvalue = 12345678;
+  int half = 0; // 'H' or 'L'
+  uint64_t limit = 0; // 0: no limit
+  uint64_t block = default_block;
+  int allow_vmsplice = 0;
+  int report = 0;
+  const char *checkpointname = NULL;
+  int resume = 0;
+  int c;
+  while ((c = getopt_long(argc, argv, "g:HLS:h", long_options, NULL)) != -1)
+    switch (c) {
+    case 'g':
+      gen = optarg;
+      break;
+    case 'l':
+      printlist();
+      return EXIT_SUCCESS;
+    case 'H':
+    case 'L':
+      half = c;
+      break;
+    case 'S':
+      seedvalue = strtoull(optarg, NULL, 10);
+      break;
+    case OPT_BYTES:
+      limit = parsebytes(optarg);
+      if (limit == 0) {
+        fprintf(stderr, "Invalid --bytes %s.\n", optarg);
+        return EXIT_FAILURE;
+      }
+      break;
+    case OPT_BLOCK:
+      block = parsebytes(optarg);
+      if (block == 0 || block > (1u << 30)) {
+        fprintf(stderr, "Invalid --block %s (at most 1G).\n", optarg);
+        return EXIT_FAILURE;
+      }
+      break;
+    case OPT_VMSPLICE:
+      allow_vmsplice = 1;
+      break;
+    case OPT_REPORT:
+      report = 1;
+      break;
+    case OPT_CHECKPOINT:
+      checkpointname = optarg;
+      break;
+    case OPT_RESUME:
+      resume = 1;
+      break;
+    case 'h':
+      printusage(argv[0]);
+      return EXIT_SUCCESS;
+    default:
+      printusage(argv[0]);
+      return EXIT_FAILURE;
+    }
+  if (gen == NULL) {
+    printusage(argv[0]);
+    return EXIT_FAILURE;
+  }
+  if (resume && checkpointname == NULL) {
+    fprintf(stderr, "--resume needs --checkpoint FILE.\n");
+    return EXIT_FAILURE;
+  }
+  if (!rng_isa_supported(RNG_ISA_BUILD)) {
+    fprintf(stderr, "%s was built for instructions that this processor lacks.\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  const rng_info *info = rng_find(gen);
+  if (info == NULL) {
+    fprintf(stderr, "Unknown generator %s (see %s --list).\n", gen, argv[0]);
+    return EXIT_FAILURE;
+  }
+  if (half != 0 && info->bits != 64) {
+    fprintf(stderr, "-%c needs a 64-bit generator; %s has %u bits.\n", half,
+            info->name, info->bits);
+    return EXIT_FAILURE;
+  }
+  void *state = rng_alloc_state(info);
+  // the state before the block being written, for the checkpoint
+  void *saved_state = rng_alloc_state(info);
+  if (state == NULL || saved_state == NULL) return EXIT_FAILURE;
+  info->seed(state, seedvalue);
+  stream_checkpoint ck = {seedvalue, half, 0};
+  if (resume && access(checkpointname, F_OK) == 0) {
+    stream_checkpoint saved;
+    if (!load_stream_checkpoint(checkpointname, info, &saved, saved_state) ||
+        saved.seed != seedvalue || saved.half != half) {
+      fprintf(stderr, "Cannot resume from %s: it is damaged, or of another generator, seed or half.\n",
+              checkpointname);
+      return EXIT_FAILURE;
+    }
+    memcpy(state, saved_state, info->state_size);
+    ck.offset = saved.offset;
+  } else if (resume) {
+    fprintf(stderr, "No checkpoint in %s: starting from the first byte.\n", checkpointname);
+  }
+
+  // whole pages, and at least 4096 bytes, which fill_block needs
+  long page = sysconf(_SC_PAGESIZE);
+  if (page < 4096) page = 4096;
+  const size_t block_size = (size_t)((block + page - 1) / page * page);
+  size_t nbuffers = 2;
+  int use_vmsplice = 0;
+#ifdef __linux__
+  struct stat st;
+  if (allow_vmsplice && fstat(STDOUT_FILENO, &st) == 0 && S_ISFIFO(st.st_mode)) {
+    // The pipe keeps the pages we vmsplice until the reader gets to them,
+    // so a block may only be refilled once the pipe cannot hold it any
+    // more: with a pipe of P bytes, the last P bytes handed over are in the
+    // ceil(P / block) most recent blocks. We ask for a pipe of one block
+    // (above /proc/sys/fs/pipe-max-size, we keep the size we have).
+    fcntl(STDOUT_FILENO, F_SETPIPE_SZ, (int)block_size);
+    int pipe_size = fcntl(STDOUT_FILENO, F_GETPIPE_SZ);
+    if (pipe_size > 0) {
+      use_vmsplice = 1;
+      nbuffers = ((size_t)pipe_size + block_size - 1) / block_size + 1;
+    }
+  }
+#endif
+  unsigned char *buffers;
+  if (posix_memalign((void **)&buffers, (size_t)page, nbuffers * block_size) != 0) {
+    fprintf(stderr, "Cannot allocate %zu bytes.\n", nbuffers * block_size);
+    return EXIT_FAILURE;
+  }
+  // a reader that stops makes write fail with EPIPE, and we stop as well
+  signal(SIGPIPE, SIG_IGN);
+
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  time_t last_checkpoint = start.tv_sec;
+  const uint64_t first = ck.offset;
+  uint64_t written = first; // from the start of the stream
+  int stopped = 0; // the reader is gone
+  for (size_t b = 0; limit == 0 || written < limit; b = (b + 1) % nbuffers) {
+    unsigned char *buf = buffers + b * block_size;
+    size_t n = block_size;
+    if (limit != 0 && limit - written < n) n = (size_t)(limit - written);
+    if (checkpointname != NULL) memcpy(saved_state, state, info->state_size);
+    fill_block(info, state, half, buf, block_size);
+#ifdef __linux__
+    if (use_vmsplice ? !vmsplice_all(STDOUT_FILENO, buf, n)
+                     : !write_all(STDOUT_FILENO, buf, n)) {
+      stopped = 1;
+      break;
+    }
+#else
+    if (!write_all(STDOUT_FILENO, buf, n)) {
+      stopped = 1;
+      break;
+    }
+#endif
+    written += n;
+    if (checkpointname != NULL) {
+      clock_gettime(CLOCK_MONOTONIC, &end);
+      if (end.tv_sec - last_checkpoint >= checkpoint_seconds && n == block_size) {
+        ck.offset = written;
+        save_stream_checkpoint(checkpointname, info, &ck, state);
+        last_checkpoint = end.tv_sec;
+      }
+    }
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  if (checkpointname != NULL) {
+    if (stopped) {
+      // the block that did not go out comes first on resume
+      ck.offset = written;
+      save_stream_checkpoint(checkpointname, info, &ck, saved_state);
+    } else {
+      remove(checkpointname); // the stream is complete
+    }
+  }
+  written -= first;
+  if (report) {
+    double seconds = (double)(end.tv_sec - start.tv_sec) +
+                     (double)(end.tv_nsec - start.tv_nsec) * 1e-9;
+    fprintf(stderr, "%s: %llu bytes in %.3f s, %.2f GB/s (%s, %zu blocks of %zu bytes)\n",
+            info->name, (unsigned long long)written, seconds,
+            seconds > 0 ? (double)written / seconds * 1e-9 : 0.0,
+            use_vmsplice ? "vmsplice" : "write", nbuffers, block_size);
+  }
+  // pages handed to the pipe stay valid for the reader after we exit
+  free(buffers);
+  rng_free_state(saved_state);
+  rng_free_state(state);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,385 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+#include "PractRand.h"
+
+#include "checkpoint.h"
+#include "registry.h"
+
+// PractRand's RNG_test with a generator of the registry built in:
+//   rngtest --gen pcg64 -H -tlmax 512GB
+// tests the same words as
+//   rngstream --gen pcg64 -H | RNG_test stdin64 -tlmax 512GB
+// but without the pipe: RNG_test reads the values from the buffer that the
+// generator fills, instead of copying them out of a pipe that rngstream
+// fills in 1 MB blocks. The options of rngstream (--gen, -H, -L, -S) are
+// ours; every other option goes to RNG_test.
+//
+// RNG_test.cpp is compiled with main renamed to RNG_test_main (see
+// practrand/CMakeLists.txt), so that we can register our generator under
+// the name "rngstream" before handing it the command line.
+//
+// RNG_test reports on the tests at every power of two, as text. With
+// --records FILE, we read these reports as they come out (RNG_test writes
+// to a pipe, and a thread copies it to our stdout) and write a line for
+// each result to FILE. With --stop-at VERDICT, the run stops after the
+// first report with a result at least as bad as VERDICT (RNG_test stops at
+// the first FAIL on its own, but reports only after 1.5 seconds of data:
+// we ask for reports from 1 MB on, unless -tlmin says otherwise).
+//
+// With --checkpoint FILE, the state of the generator and the number of
+// bytes handed to RNG_test go to FILE every minute (as with rngstream, see
+// checkpoint.h), and --resume goes on with the stream from there. PractRand
+// 0.96 cannot save the state of its tests (they have no serialization), so
+// the tests start over at that point: the lengths of the reports that follow
+// count from there, and the data tested before the stop does not add up.
+
+int RNG_test_main(int argc, char **argv);
+
+namespace RNG_Factories {
+extern std::map<std::string, PractRand::RNGs::vRNG *(*)(std::vector<std::string> &params)>
+    RNG_factory_index;
+}
+
+namespace {
+
+const rng_info *info = nullptr;
+uint64_t seedvalue = 12345678;
+int half = 0; // 'H' or 'L'
+const char *checkpointname = nullptr;
+stream_checkpoint ck; // the offset of the next buffer
+void *resumed_state = nullptr; // from the checkpoint, if we resume
+
+// The words that rngstream writes to stdout, in the same order: 64-bit
+// words as they are, two 32-bit values (or two halves) per word, the low
+// half of a 128-bit value first. Like RNG_stdin64, the generator ignores
+// the seed of RNG_test: -S seeds it.
+class RNG_rngstream : public PractRand::RNGs::vRNG64 {
+  enum { BUFF_SIZE = 4096 }; // in 64-bit words
+  void *state;
+  uint64_t buffer[BUFF_SIZE] __attribute__((aligned(16)));
+  uint64_t values[BUFF_SIZE] __attribute__((aligned(16)));
+  const uint64_t *pos, *end;
+  std::time_t last_checkpoint;
+
+  void refill() {
+    if (checkpointname != nullptr && std::time(nullptr) - last_checkpoint >= checkpoint_seconds) {
+      save_stream_checkpoint(checkpointname, info, &ck, state);
+      last_checkpoint = std::time(nullptr);
+    }
+    ck.offset += half != 0 ? BUFF_SIZE * sizeof(uint32_t) : sizeof(buffer);
+    if (half != 0) {
+      const int shift = (half == 'H') ? 32 : 0;
+      uint32_t *out = reinterpret_cast<uint32_t *>(buffer);
+      info->fill(state, values, BUFF_SIZE);
+      for (size_t k = 0; k < BUFF_SIZE; k++) out[k] = uint32_t(values[k] >> shift);
+      pos = buffer;
+      end = buffer + BUFF_SIZE / 2;
+    } else {
+      info->fill(state, buffer, sizeof(buffer) * 8 / info->bits);
+      pos = buffer;
+      end = buffer + BUFF_SIZE;
+    }
+  }
+
+public:
+  RNG_rngstream() : state(rng_alloc_state(info)), last_checkpoint(std::time(nullptr)) {
+    if (state == nullptr) std::exit(EXIT_FAILURE);
+    info->seed(state, seedvalue);
+    if (resumed_state != nullptr) std::memcpy(state, resumed_state, info->state_size);
+    refill();
+  }
+  ~RNG_rngstream() { rng_free_state(state); }
+  virtual PractRand::Uint64 raw64() {
+    uint64_t rv = *(pos++);
+    if (pos == end) refill();
+    return rv;
+  }
+  virtual std::string get_name() const {
+    std::string name = info->name;
+    if (half != 0) name += half == 'H' ? " -H" : " -L";
+    return name;
+  }
+  virtual void walk_state(PractRand::StateWalkingObject *) {}
+};
+
+// The verdicts of RNG_test, from the mildest to the worst.
+const char *const verdicts[] = {
+    "normal",          "normalish",       "unusual",      "mildly suspicious",
+    "suspicious",      "very suspicious", "VERY SUSPICIOUS", "FAIL",
+    "FAIL !",          "FAIL !!",         "FAIL !!!",     "FAIL !!!!",
+    "FAIL !!!!!",      "FAIL !!!!!!",     "FAIL !!!!!!!", "FAIL !!!!!!!!"};
+const int number_of_verdicts = sizeof(verdicts) / sizeof(verdicts[0]);
+
+std::string without_spaces(const std::string &text) {
+  std::string out;
+  for (char c : text)
+    if (c != ' ') out += c;
+  return out;
+}
+
+// the rank of a verdict given on the command line ("FAIL!!" is "FAIL !!"),
+// -1 if there is no such verdict
+int verdict_rank(const std::string &text) {
+  for (int v = 0; v < number_of_verdicts; v++)
+    if (without_spaces(verdicts[v]) == without_spaces(text)) return v;
+  return -1;
+}
+
+std::string trim(const std::string &text) {
+  size_t begin = text.find_first_not_of(" \t\n");
+  if (begin == std::string::npos) return "";
+  return text.substr(begin, text.find_last_not_of(" \t\n") + 1 - begin);
+}
+
+FILE *records = nullptr;
+int stop_at = -1; // the rank of the verdict that stops the run, or -1
+int real_stdout = -1;
+std::thread reader;
+
+void write_all(int fd, const char *buf, size_t n) {
+  while (n > 0) {
+    ssize_t w = write(fd, buf, n);
+    if (w <= 0) return;
+    buf += w;
+    n -= size_t(w);
+  }
+}
+
+// One line of results, as print_result writes it in its default table:
+//   "  BCFN(2+0,13-0,T)                  R= +12.3  p =  1.1e-5   suspicious"
+// We take the verdict that ends the line (the longest that fits: "very
+// suspicious" rather than "suspicious"), then the raw value after "R=",
+// and the p-value between the two. Returns the rank of the verdict, -1 if
+// the line is not a result.
+int parse_result(const std::string &line, std::string &name, std::string &raw,
+                 std::string &p) {
+  const std::string text = trim(line);
+  size_t r = text.find(" R=");
+  if (r == std::string::npos) return -1;
+  int rank = -1;
+  size_t verdict_length = 0;
+  for (int v = 0; v < number_of_verdicts; v++) {
+    size_t n = std::strlen(verdicts[v]);
+    if (n > verdict_length && text.size() > n + r &&
+        text.compare(text.size() - n, n, verdicts[v]) == 0 && text[text.size() - n - 1] == ' ') {
+      rank = v;
+      verdict_length = n;
+    }
+  }
+  if (rank < 0) return -1;
+  name = trim(text.substr(0, r));
+  size_t raw_begin = text.find_first_not_of(' ', r + 3);
+  size_t raw_end = text.find(' ', raw_begin);
+  raw = text.substr(raw_begin, raw_end - raw_begin);
+  p = trim(text.substr(raw_end, text.size() - verdict_length - raw_end));
+  for (const char *prefix : {"p~=", "p ="})
+    if (p.compare(0, std::strlen(prefix), prefix) == 0) p = trim(p.substr(std::strlen(prefix)));
+  return rank;
+}
+
+// Copies the output of RNG_test to our stdout, and turns each report into
+// records: a line per result (length as log2 of the bytes, test, raw
+// value, p-value, verdict), then a line "*" with the worst verdict of the
+// report, results not shown included.
+void read_reports(int fd) {
+  FILE *in = fdopen(fd, "r");
+  char buffer[4096];
+  std::string length;
+  int worst = -1; // -1: not in a report
+  while (std::fgets(buffer, sizeof(buffer), in) != nullptr) {
+    write_all(real_stdout, buffer, std::strlen(buffer));
+    const std::string line = buffer;
+    std::string name, raw, p;
+    int rank;
+    if (line.compare(0, 4, "rng=") == 0) {
+      if (records != nullptr && std::ftell(records) == 0)
+        std::fprintf(records, "# %s# log2(bytes)\ttest\traw\tp\tverdict\n", buffer);
+    } else if (line.compare(0, 8, "length= ") == 0) {
+      // "length= 1 gigabyte (2^30 bytes), time= 3.4 seconds"
+      size_t begin = line.find("(2^");
+      length = (begin == std::string::npos) ? "?" : line.substr(begin + 3, line.find(' ', begin) - begin - 3);
+      worst = 0;
+    } else if (worst >= 0 && (rank = parse_result(line, name, raw, p)) >= 0) {
+      if (records != nullptr)
+        std::fprintf(records, "%s\t%s\t%s\t%s\t%s\n", length.c_str(), name.c_str(), raw.c_str(),
+                     p.c_str(), verdicts[rank]);
+      if (rank > worst) worst = rank;
+    } else if (worst >= 0 && trim(line).empty()) {
+      if (records != nullptr) {
+        std::fprintf(records, "%s\t*\t-\t-\t%s\n", length.c_str(), verdicts[worst]);
+        std::fflush(records);
+      }
+      if (stop_at >= 0 && worst >= stop_at) {
+        const char *message = "Stopped: a result is at least as bad as the --stop-at verdict.\n";
+        write_all(real_stdout, message, std::strlen(message));
+        if (records != nullptr) std::fclose(records);
+        if (checkpointname != nullptr) std::remove(checkpointname); // the run is complete
+        _exit(EXIT_SUCCESS);
+      }
+      worst = -1;
+    }
+  }
+  std::fclose(in);
+}
+
+// at exit: RNG_test is done, the reader gets the end of its output
+void finish_reports() {
+  std::fflush(stdout);
+  close(STDOUT_FILENO);
+  if (reader.joinable()) reader.join();
+  if (records != nullptr) std::fclose(records);
+}
+
+PractRand::RNGs::vRNG *rngstream_factory(std::vector<std::string> &params) {
+  if (params.size() != 0) return nullptr;
+  return new RNG_rngstream();
+}
+
+void printusage(const char *command) {
+  std::printf("Usage: %s --gen NAME [-H | -L] [-S SEED] [--records FILE]\n"
+              "       [--stop-at VERDICT] [--checkpoint FILE [--resume]] [RNG_test options]\n",
+              command);
+  std::printf(" --gen NAME         the generator (see rngstream --list)\n");
+  std::printf(" -H                 the most significant 32 bits of each 64-bit word\n");
+  std::printf(" -L                 the least significant 32 bits of each 64-bit word\n");
+  std::printf(" -S SEED            the seed (default: 12345678)\n");
+  std::printf(" --records FILE     write each result of each report to FILE\n");
+  std::printf(" --stop-at VERDICT  stop at the first report with a result at least this bad\n");
+  std::printf("                    (e.g. 'very suspicious', FAIL, 'FAIL !!'), reporting from 1 MB on\n");
+  std::printf(" --checkpoint FILE  save the state and the offset of the stream to FILE\n");
+  std::printf(" --resume           go on with the stream from the checkpoint (same options);\n"
+              "                    the tests of RNG_test start over there\n");
+  std::printf("The other options go to RNG_test (e.g., -tlmax 512GB, -multithreaded).\n");
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const char *gen = nullptr;
+  const char *recordname = nullptr;
+  bool resume = false;
+  bool has_tlmin = false;
+  // RNG_test sees: its name, our generator, then the options we do not take
+  std::vector<char *> args = {argv[0], const_cast<char *>("rngstream")};
+  for (int i = 1; i < argc; i++) {
+    if ((!std::strcmp(argv[i], "--gen") || !std::strcmp(argv[i], "-g")) &&
+        i + 1 < argc) {
+      gen = argv[++i];
+    } else if (!std::strcmp(argv[i], "-H") || !std::strcmp(argv[i], "-L")) {
+      half = argv[i][1];
+    } else if (!std::strcmp(argv[i], "-S") && i + 1 < argc) {
+      seedvalue = std::strtoull(argv[++i], nullptr, 10);
+    } else if (!std::strcmp(argv[i], "--checkpoint") && i + 1 < argc) {
+      checkpointname = argv[++i];
+    } else if (!std::strcmp(argv[i], "--resume")) {
+      resume = true;
+    } else if (!std::strcmp(argv[i], "--records") && i + 1 < argc) {
+      recordname = argv[++i];
+    } else if (!std::strcmp(argv[i], "--stop-at") && i + 1 < argc) {
+      stop_at = verdict_rank(argv[++i]);
+      if (stop_at < 0) {
+        std::fprintf(stderr, "Unknown verdict %s: it is one of", argv[i]);
+        for (int v = 0; v < number_of_verdicts; v++) std::fprintf(stderr, " '%s'", verdicts[v]);
+        std::fprintf(stderr, ".\n");
+        return EXIT_FAILURE;
+      }
+    } else if (!std::strcmp(argv[i], "--help")) {
+      printusage(argv[0]);
+      return EXIT_SUCCESS;
+    } else {
+      if (!std::strcmp(argv[i], "-tlmin")) has_tlmin = true;
+      args.push_back(argv[i]);
+    }
+  }
+  if (gen == nullptr) {
+    printusage(argv[0]);
+    return EXIT_FAILURE;
+  }
+  if (resume && checkpointname == nullptr) {
+    std::fprintf(stderr, "--resume needs --checkpoint FILE.\n");
+    return EXIT_FAILURE;
+  }
+  if (!rng_isa_supported(RNG_ISA_BUILD)) {
+    std::fprintf(stderr, "%s was built for instructions that this processor lacks.\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  info = rng_find(gen);
+  if (info == nullptr) {
+    std::fprintf(stderr, "Unknown generator %s (see rngstream --list).\n", gen);
+    return EXIT_FAILURE;
+  }
+  if (half != 0 && info->bits != 64) {
+    std::fprintf(stderr, "-%c needs a 64-bit generator; %s has %u bits.\n", half,
+                 info->name, info->bits);
+    return EXIT_FAILURE;
+  }
+  ck.seed = seedvalue;
+  ck.half = half;
+  if (resume && access(checkpointname, F_OK) == 0) {
+    stream_checkpoint saved;
+    resumed_state = rng_alloc_state(info);
+    if (resumed_state == nullptr) return EXIT_FAILURE;
+    if (!load_stream_checkpoint(checkpointname, info, &saved, resumed_state) ||
+        saved.seed != seedvalue || saved.half != half) {
+      std::fprintf(stderr, "Cannot resume from %s: it is damaged, or of another generator, seed or half.\n",
+                   checkpointname);
+      return EXIT_FAILURE;
+    }
+    ck.offset = saved.offset;
+    std::printf("Resuming at byte %llu of the stream: the tests start over there.\n",
+                (unsigned long long)ck.offset);
+  } else if (resume) {
+    std::fprintf(stderr, "No checkpoint in %s: starting from the first byte.\n", checkpointname);
+  }
+  RNG_Factories::RNG_factory_index["rngstream"] = rngstream_factory;
+  if (stop_at >= 0) {
+    // we stop the run, and RNG_test goes on until then
+    args.push_back(const_cast<char *>("-tlmaxonly"));
+    if (!has_tlmin) {
+      args.push_back(const_cast<char *>("-tlmin"));
+      args.push_back(const_cast<char *>("1MB"));
+    }
+  }
+  if (recordname != nullptr) {
+    // a resumed run adds its reports to those before
+    records = std::fopen(recordname, resumed_state != nullptr ? "a" : "w");
+    if (records == nullptr) {
+      std::perror(recordname);
+      return EXIT_FAILURE;
+    }
+    std::fseek(records, 0, SEEK_END);
+    if (resumed_state != nullptr && std::ftell(records) > 0) {
+      std::fprintf(records, "# resumed at byte %llu: the lengths below count from there\n",
+                   (unsigned long long)ck.offset);
+    }
+  }
+  if (records != nullptr || stop_at >= 0) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+      std::perror("pipe");
+      return EXIT_FAILURE;
+    }
+    std::fflush(stdout);
+    real_stdout = dup(STDOUT_FILENO);
+    dup2(fds[1], STDOUT_FILENO);
+    close(fds[1]);
+    // a report reaches the reader as soon as RNG_test prints it
+    std::setvbuf(stdout, nullptr, _IOLBF, 0);
+    reader = std::thread(read_reports, fds[0]);
+    std::atexit(finish_reports);
+  }
+  args.push_back(nullptr);
+  const int result = RNG_test_main(int(args.size()) - 1, args.data());
+  // RNG_test returns once the run is complete (not on a bad option)
+  if (checkpointname != nullptr) std::remove(checkpointname);
+  return result;
+}
@@ -0,0 +1,16 @@
+#!/usr/bin/env bash
+# Normally this script is executed in the context of another script,
+# with the "." command. It lists the generators of the registry (see
+# ./rngstream --list), or only those named on the command line of that
+# script, each 64-bit generator twice: as 64-bit words, and as their most
+# significant 32 bits (-H).
+declare -a commands=()
+while read -r gen bits; do
+  if [ $# -gt 0 ] && [[ ! " $* " =~ " $gen " ]]; then
+    continue
+  fi
+  commands+=("$gen")
+  if [ "$bits" == "64" ]; then
+    commands+=("$gen -H")
+  fi
+done < <(./rngstream --list)
@@ -4,6 +4,7 @@
 #include "splitmix64.h"
 #include "splitmix63.h"
 #include <stdint.h>
+#include "fill.h"
 
 /* Written in 2023 by Tomasz R. Dziala (tomasz-dziala@wp.pl).
  
@@ -36,19 +37,34 @@ void initializator(void)
     }
 } */
 
-static uint64_t CG_s, CG_k = 0, CG_weyl = 0;
-static __uint128_t CG_x;
+typedef struct {
+  __uint128_t x;
+  uint64_t s, k, weyl;
+} CG128_64_state;
 
-// call this to seed CG_x and CG_s
-static inline void CG128_64_seed(uint64_t seed) {
-	CG_x = ((__uint128_t)splitmix64_r(&seed) << 64) | (splitmix64_r(&seed) | 1);
-	CG_s = (splitmix63_r(&seed) << 1) | 1;
+static CG128_64_state g_CG128_64_state;
+
+// seeds x and s, and resets k and weyl
+static inline void CG128_64_seed_r(CG128_64_state *state, uint64_t seed) {
+	state->x = ((__uint128_t)splitmix64_r(&seed) << 64) | (splitmix64_r(&seed) | 1);
+	state->s = (splitmix63_r(&seed) << 1) | 1;
+	state->k = 0;
+	state->weyl = 0;
 }
 
-static inline __uint128_t CG128_64(void)
+static inline __uint128_t CG128_64_r(CG128_64_state *state)
 {
-  CG_x = (CG_x | 1) * ((CG_k += CG_x) >> 1) ^ (CG_weyl += CG_s);
-  return CG_k >> 48 ^ CG_x;
+  state->x = (state->x | 1) * ((state->k += state->x) >> 1) ^ (state->weyl += state->s);
+  return state->k >> 48 ^ state->x;
 }
 
+// call this to seed the global state
+static inline void CG128_64_seed(uint64_t seed) {
+	CG128_64_seed_r(&g_CG128_64_state, seed);
+}
+
+static inline __uint128_t CG128_64(void) { return CG128_64_r(&g_CG128_64_state); }
+
+FILL_GENERIC(CG128_64, CG128_64_state, __uint128_t, g_CG128_64_state)
+
 #endif // CG128_64_H
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include "splitmix64.h"
 #include <stdint.h>
+#include "fill.h"
 
 /* Written in 2023 by Tomasz R. Dziala (tomasz-dziala@wp.pl).
  
@@ -35,17 +36,30 @@ void initializator(void)
     }
 } */
 
-static __uint128_t CG128_c[4];
+typedef struct {
+  __uint128_t c[4];
+} CG128_state;
 
-// call this one before calling CG128
-static inline void CG128_seed(uint64_t seed) {
-  CG128_c[0] = ((__uint128_t)splitmix64_r(&seed) << 64) | (splitmix64_r(&seed) | 1);
+static CG128_state g_CG128_state;
+
+// seeds c[0] and sets the other elements to zero
+static inline void CG128_seed_r(CG128_state *state, uint64_t seed) {
+  state->c[0] = ((__uint128_t)splitmix64_r(&seed) << 64) | (splitmix64_r(&seed) | 1);
+  state->c[1] = state->c[2] = state->c[3] = 0;
 }
 
-static inline __uint128_t CG128(void)
+static inline __uint128_t CG128_r(CG128_state *state)
 {
-    CG128_c[1] = (CG128_c[1] >> 1) * ((CG128_c[2] += CG128_c[1]) | 1) ^ (CG128_c[3] += CG128_c[0]);
-    return CG128_c[2] >> 96 ^ CG128_c[1];
+    __uint128_t *c = state->c;
+    c[1] = (c[1] >> 1) * ((c[2] += c[1]) | 1) ^ (c[3] += c[0]);
+    return c[2] >> 96 ^ c[1];
 }
 
+// call this one before calling CG128
+static inline void CG128_seed(uint64_t seed) { CG128_seed_r(&g_CG128_state, seed); }
+
+static inline __uint128_t CG128(void) { return CG128_r(&g_CG128_state); }
+
+FILL_GENERIC(CG128, CG128_state, __uint128_t, g_CG128_state)
+
 #endif // CG128_H
@@ -3,6 +3,7 @@
 
 #include "splitmix63.h"
 #include <stdint.h>
+#include "fill.h"
 
 /* Written in 2023 by Tomasz R. Dziala (tomasz-dziala@wp.pl).
  
@@ -35,17 +36,30 @@ void initializator(void)
     }
 } */
 
-static uint64_t CG64_c[4];
+typedef struct {
+  uint64_t c[4];
+} CG64_state;
 
-// call this to seed CG64_c[0]
-static inline void CG64_seed(uint64_t seed) {
-	CG64_c[0] = (splitmix63_r(&seed) << 1) | 1;
+static CG64_state g_CG64_state;
+
+// seeds c[0] and sets the other elements to zero
+static inline void CG64_seed_r(CG64_state *state, uint64_t seed) {
+	state->c[0] = (splitmix63_r(&seed) << 1) | 1;
+	state->c[1] = state->c[2] = state->c[3] = 0;
 }
 
-static inline uint64_t CG64(void)
+static inline uint64_t CG64_r(CG64_state *state)
 {
-	CG64_c[1] = (CG64_c[1] >> 1) * ((CG64_c[2] += CG64_c[1]) | 1) ^ (CG64_c[3] += CG64_c[0]);
-	return CG64_c[2] >> 48 ^ CG64_c[1];
+	uint64_t *c = state->c;
+	c[1] = (c[1] >> 1) * ((c[2] += c[1]) | 1) ^ (c[3] += c[0]);
+	return c[2] >> 48 ^ c[1];
 }
 
+// call this to seed the global state
+static inline void CG64_seed(uint64_t seed) { CG64_seed_r(&g_CG64_state, seed); }
+
+static inline uint64_t CG64(void) { return CG64_r(&g_CG64_state); }
+
+FILL_GENERIC(CG64, CG64_state, uint64_t, g_CG64_state)
+
 #endif // CG64_H
\ No newline at end of file
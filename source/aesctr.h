@@ -15,14 +15,23 @@
 #include <stdint.h>
 #include <string.h>
 
+#include "avx512warnings.h"
+
+// number of blocks encrypted together by aesctr_r and aesctr_fill_bytes_r; 4,
+// 8 or 16, can be set before including this header. It does not change the
+// output: block i is always the encryption of counter i.
+#ifndef AESCTR_UNROLL
 #define AESCTR_UNROLL 4
+#endif
+#define AESCTR_MAX_UNROLL 16
 #define AESCTR_ROUNDS 10
 
 typedef struct {
-  uint8_t state[16 * AESCTR_UNROLL];
-  __m128i ctr[AESCTR_UNROLL];
+  uint8_t state[16 * AESCTR_MAX_UNROLL]; // buffered key stream
   __m128i seed[AESCTR_ROUNDS + 1];
-  size_t offset;
+  uint64_t counter; // next block to encrypt
+  size_t length;    // bytes in state
+  size_t offset;    // bytes of state already handed out
 } aesctr_state;
 
 #define AES_ROUND(rcon, index)                                                 \
@@ -66,41 +75,199 @@ static inline void aesctr_seed_r(aesctr_state *state, uint64_t seed) {
   AES_ROUND(0x1b, 9);
   AES_ROUND(0x36, 10);
 
-  for (int i = 0; i < AESCTR_UNROLL; ++i) {
-    state->ctr[i] = _mm_set_epi64x(0, i);
-  }
-  state->offset = 16 * AESCTR_UNROLL;
+  state->counter = 0;
+  state->length = 0;
+  state->offset = 0;
 }
 
 #undef AES_ROUND
 
-static inline uint64_t aesctr_r(aesctr_state *state) {
-  if (__builtin_expect(state->offset >= 16 * AESCTR_UNROLL, 0)) {
-    __m128i work[AESCTR_UNROLL];
-    for (int i = 0; i < AESCTR_UNROLL; ++i) {
-      work[i] = _mm_xor_si128(state->ctr[i], state->seed[0]);
-    }
-    for (int r = 1; r <= AESCTR_ROUNDS - 1; ++r) {
-      const __m128i subkey = state->seed[r];
-      for (int i = 0; i < AESCTR_UNROLL; ++i) {
-        work[i] = _mm_aesenc_si128(work[i], subkey);
-      }
+// Encrypts the next `blocks` counter blocks into dst. It is always inlined,
+// so that blocks is a constant and the loops are fully unrolled.
+static inline __attribute__((always_inline)) void
+aesctr_encrypt_r(aesctr_state *state, uint8_t *dst, const int blocks) {
+  __m128i work[AESCTR_MAX_UNROLL];
+  for (int i = 0; i < blocks; ++i) {
+    work[i] = _mm_xor_si128(_mm_set_epi64x(0, state->counter + i),
+                            state->seed[0]);
+  }
+  for (int r = 1; r <= AESCTR_ROUNDS - 1; ++r) {
+    const __m128i subkey = state->seed[r];
+    for (int i = 0; i < blocks; ++i) {
+      work[i] = _mm_aesenc_si128(work[i], subkey);
     }
-    for (int i = 0; i < AESCTR_UNROLL; ++i) {
-      state->ctr[i] =
-          _mm_add_epi64(state->ctr[i], _mm_set_epi64x(0, AESCTR_UNROLL));
-      _mm_storeu_si128(
-          (__m128i *)&state->state[16 * i],
-          _mm_aesenclast_si128(work[i], state->seed[AESCTR_ROUNDS]));
+  }
+  for (int i = 0; i < blocks; ++i) {
+    _mm_storeu_si128((__m128i *)(dst + 16 * i),
+                     _mm_aesenclast_si128(work[i], state->seed[AESCTR_ROUNDS]));
+  }
+  state->counter += blocks;
+}
+
+#if defined(__VAES__) && defined(__AVX512F__)
+#define AESCTR_VAES_LANES 4 // blocks per VAES instruction
+typedef __m512i aesctr_vaes_vec;
+#define aesctr_vaes_broadcast(k) avx512_broadcast_i32x4(k)
+#define aesctr_vaes_add(a, b) _mm512_add_epi64(a, b)
+#define aesctr_vaes_xor(a, b) _mm512_xor_si512(a, b)
+#define aesctr_vaes_enc(a, k) _mm512_aesenc_epi128(a, k)
+#define aesctr_vaes_enclast(a, k) _mm512_aesenclast_epi128(a, k)
+#define aesctr_vaes_storeu(p, a) _mm512_storeu_si512((void *)(p), a)
+#define aesctr_vaes_counters(c)                                               \
+  _mm512_set_epi64(0, (long long)(c) + 3, 0, (long long)(c) + 2, 0,           \
+                   (long long)(c) + 1, 0, (long long)(c))
+#define aesctr_vaes_step() _mm512_set_epi64(0, 4, 0, 4, 0, 4, 0, 4)
+#elif defined(__VAES__) && defined(__AVX2__)
+#define AESCTR_VAES_LANES 2
+typedef __m256i aesctr_vaes_vec;
+#define aesctr_vaes_broadcast(k) _mm256_broadcastsi128_si256(k)
+#define aesctr_vaes_add(a, b) _mm256_add_epi64(a, b)
+#define aesctr_vaes_xor(a, b) _mm256_xor_si256(a, b)
+#define aesctr_vaes_enc(a, k) _mm256_aesenc_epi128(a, k)
+#define aesctr_vaes_enclast(a, k) _mm256_aesenclast_epi128(a, k)
+#define aesctr_vaes_storeu(p, a) _mm256_storeu_si256((__m256i *)(p), a)
+#define aesctr_vaes_counters(c)                                               \
+  _mm256_set_epi64x(0, (long long)(c) + 1, 0, (long long)(c))
+#define aesctr_vaes_step() _mm256_set_epi64x(0, 2, 0, 2)
+#endif
+
+#ifdef AESCTR_VAES_LANES
+// Same as aesctr_encrypt_r, with VAES: each instruction encrypts
+// AESCTR_VAES_LANES blocks. blocks must be a multiple of AESCTR_VAES_LANES.
+static inline __attribute__((always_inline)) void
+aesctr_vaes_encrypt_r(aesctr_state *state, uint8_t *dst, const int blocks) {
+  aesctr_vaes_vec work[AESCTR_MAX_UNROLL / AESCTR_VAES_LANES];
+  const int vectors = blocks / AESCTR_VAES_LANES;
+  aesctr_vaes_vec ctr = aesctr_vaes_counters(state->counter);
+  const aesctr_vaes_vec key0 = aesctr_vaes_broadcast(state->seed[0]);
+  for (int i = 0; i < vectors; ++i) {
+    work[i] = aesctr_vaes_xor(ctr, key0);
+    ctr = aesctr_vaes_add(ctr, aesctr_vaes_step());
+  }
+  for (int r = 1; r <= AESCTR_ROUNDS - 1; ++r) {
+    const aesctr_vaes_vec subkey = aesctr_vaes_broadcast(state->seed[r]);
+    for (int i = 0; i < vectors; ++i) {
+      work[i] = aesctr_vaes_enc(work[i], subkey);
     }
-    state->offset = 0;
   }
+  const aesctr_vaes_vec last = aesctr_vaes_broadcast(state->seed[AESCTR_ROUNDS]);
+  for (int i = 0; i < vectors; ++i) {
+    aesctr_vaes_storeu(dst + 16 * AESCTR_VAES_LANES * i,
+                       aesctr_vaes_enclast(work[i], last));
+  }
+  state->counter += blocks;
+}
+#endif
+
+// encrypts the next `blocks` blocks into dst, with VAES if vaes is set
+static inline __attribute__((always_inline)) void
+aesctr_blocks_r(aesctr_state *state, uint8_t *dst, const int blocks,
+                const int vaes) {
+#ifdef AESCTR_VAES_LANES
+  if (vaes && blocks % AESCTR_VAES_LANES == 0) {
+    aesctr_vaes_encrypt_r(state, dst, blocks);
+    return;
+  }
+#else
+  (void)vaes;
+#endif
+  aesctr_encrypt_r(state, dst, blocks);
+}
+
+static inline __attribute__((always_inline)) void
+aesctr_refill_r(aesctr_state *state, const int unroll, const int vaes) {
+  aesctr_blocks_r(state, state->state, unroll, vaes);
+  state->length = 16 * unroll;
+  state->offset = 0;
+}
+
+// after a fill of an odd number of bytes, the next value may straddle the
+// end of the buffer; this is rare, so it is kept out of line (any number of
+// blocks can refill the buffer, the key stream is the same)
+static __attribute__((noinline, unused)) uint64_t
+aesctr_straddle_r(aesctr_state *state) {
+  uint64_t output = 0;
+  size_t left = state->length - state->offset;
+  memcpy(&output, &state->state[state->offset], left);
+  aesctr_refill_r(state, AESCTR_MAX_UNROLL, 0);
+  memcpy((uint8_t *)&output + left, state->state, sizeof(output) - left);
+  state->offset = sizeof(output) - left;
+  return output;
+}
+
+static inline __attribute__((always_inline)) uint64_t
+aesctr_next_r(aesctr_state *state, const int unroll, const int vaes) {
   uint64_t output = 0;
+  if (__builtin_expect(state->offset + sizeof(output) > state->length, 0)) {
+    if (state->offset != state->length) {
+      return aesctr_straddle_r(state);
+    }
+    aesctr_refill_r(state, unroll, vaes);
+  }
   memcpy(&output, &state->state[state->offset], sizeof(output));
   state->offset += sizeof(output);
   return output;
 }
 
+static inline __attribute__((always_inline)) void
+aesctr_fill_blocks_r(aesctr_state *state, void *dst, size_t bytes,
+                     const int unroll, const int vaes) {
+  uint8_t *out = (uint8_t *)dst;
+  size_t buffered = state->length - state->offset;
+  if (buffered > bytes) {
+    buffered = bytes;
+  }
+  memcpy(out, &state->state[state->offset], buffered);
+  state->offset += buffered;
+  out += buffered;
+  bytes -= buffered;
+  for (; bytes >= (size_t)16 * unroll; bytes -= 16 * unroll) {
+    aesctr_blocks_r(state, out, unroll, vaes);
+    out += 16 * unroll;
+  }
+  for (; bytes >= 16; bytes -= 16) {
+    aesctr_encrypt_r(state, out, 1);
+    out += 16;
+  }
+  if (bytes > 0) {
+    aesctr_refill_r(state, unroll, vaes);
+    memcpy(out, state->state, bytes);
+    state->offset = bytes;
+  }
+}
+
+// returns the next 8 bytes of the key stream, refilling the buffer with
+// `unroll` blocks when needed
+static inline __attribute__((always_inline)) uint64_t
+aesctr_unrolled_r(aesctr_state *state, const int unroll) {
+  return aesctr_next_r(state, unroll, 0);
+}
+
+// writes the next `bytes` bytes of the key stream to dst: whole groups of
+// `unroll` blocks are encrypted straight into dst, only the partial tail
+// goes through the buffer
+static inline __attribute__((always_inline)) void
+aesctr_fill_unrolled_r(aesctr_state *state, void *dst, size_t bytes,
+                       const int unroll) {
+  aesctr_fill_blocks_r(state, dst, bytes, unroll, 0);
+}
+
+static inline uint64_t aesctr_r(aesctr_state *state) {
+  return aesctr_unrolled_r(state, AESCTR_UNROLL);
+}
+
+static inline void aesctr_fill_bytes_r(aesctr_state *state, void *dst,
+                                       size_t bytes) {
+  aesctr_fill_unrolled_r(state, dst, bytes, AESCTR_UNROLL);
+}
+
+// writes the next n words, the same ones that n calls to aesctr_r would have
+// returned
+static inline void aesctr_fill_r(aesctr_state *state, uint64_t *out,
+                                 size_t n) {
+  aesctr_fill_bytes_r(state, out, n * sizeof(uint64_t));
+}
+
 static aesctr_state g_aesctr_state;
 
 static inline void aesctr_seed(uint64_t seed) {
@@ -109,7 +276,57 @@ static inline void aesctr_seed(uint64_t seed) {
 
 static inline uint64_t aesctr() { return aesctr_r(&g_aesctr_state); }
 
-#undef AESCTR_UNROLL
+static inline void aesctr_fill_bytes(void *dst, size_t bytes) {
+  aesctr_fill_bytes_r(&g_aesctr_state, dst, bytes);
+}
+
+static inline void aesctr_fill(uint64_t *out, size_t n) {
+  aesctr_fill_r(&g_aesctr_state, out, n);
+}
+
+#ifdef AESCTR_VAES_LANES
+// aesctr_vaes is aesctr computed with VAES, 16 blocks at a time: the key
+// stream is the same
+static inline uint64_t aesctr_vaes_r(aesctr_state *state) {
+  return aesctr_next_r(state, AESCTR_MAX_UNROLL, 1);
+}
+
+static inline void aesctr_vaes_fill_bytes_r(aesctr_state *state, void *dst,
+                                            size_t bytes) {
+  aesctr_fill_blocks_r(state, dst, bytes, AESCTR_MAX_UNROLL, 1);
+}
+
+static inline void aesctr_vaes_fill_r(aesctr_state *state, uint64_t *out,
+                                      size_t n) {
+  aesctr_vaes_fill_bytes_r(state, out, n * sizeof(uint64_t));
+}
+
+static aesctr_state g_aesctr_vaes_state;
+
+static inline void aesctr_vaes_seed(uint64_t seed) {
+  aesctr_seed_r(&g_aesctr_vaes_state, seed);
+}
+
+static inline uint64_t aesctr_vaes() { return aesctr_vaes_r(&g_aesctr_vaes_state); }
+
+static inline void aesctr_vaes_fill_bytes(void *dst, size_t bytes) {
+  aesctr_vaes_fill_bytes_r(&g_aesctr_vaes_state, dst, bytes);
+}
+
+static inline void aesctr_vaes_fill(uint64_t *out, size_t n) {
+  aesctr_vaes_fill_r(&g_aesctr_vaes_state, out, n);
+}
+
+#undef aesctr_vaes_broadcast
+#undef aesctr_vaes_add
+#undef aesctr_vaes_xor
+#undef aesctr_vaes_enc
+#undef aesctr_vaes_enclast
+#undef aesctr_vaes_storeu
+#undef aesctr_vaes_counters
+#undef aesctr_vaes_step
+#endif // AESCTR_VAES_LANES
+
 #undef AESCTR_ROUNDS
 #endif // __AES__
 #endif
@@ -11,25 +11,37 @@
 #include <stdint.h>
 #include <string.h>
 
+#include "avx512warnings.h"
 #include "splitmix64.h"
 
+// each step of the generator produces 4 words; the buffer holds up to 4
+// steps (the VAES version computes 4 steps at once)
+#define AESDRAGONTAMER_MAX_STEPS 4
+
 typedef struct {
   __m128i state;
   __m128i increment;
-  uint64_t buffer[4];
+  uint64_t buffer[4 * AESDRAGONTAMER_MAX_STEPS];
   size_t offset;
+  size_t length; // words in buffer
 } aesdragontamer_state;
 
-static inline void aesdragontamer_tobuffer_r(aesdragontamer_state *state) {
+// writes the next step (4 words) to out
+static inline void aesdragontamer_step_r(aesdragontamer_state *state,
+                                         uint64_t *out) {
   state->state = _mm_add_epi64(state->state, state->increment);
   __m128i penultimate = _mm_aesenc_si128(state->state, state->increment);
   __m128i penultimate1 = _mm_aesenc_si128(penultimate, state->increment);
   __m128i penultimate2 = _mm_aesdec_si128(penultimate, state->increment);
 
-  _mm_storeu_si128((__m128i *)state->buffer, penultimate1); // stores 2 uint64_t
-  _mm_storeu_si128((__m128i *)state->buffer + 1,
-                   penultimate2); // stores 2 uint64_t
+  _mm_storeu_si128((__m128i *)out, penultimate1);     // stores 2 uint64_t
+  _mm_storeu_si128((__m128i *)out + 1, penultimate2); // stores 2 uint64_t
+}
+
+static inline void aesdragontamer_tobuffer_r(aesdragontamer_state *state) {
+  aesdragontamer_step_r(state, state->buffer);
   state->offset = 0;
+  state->length = 4;
 }
 
 static inline void aesdragontamer_seed_r(aesdragontamer_state *state,
@@ -37,6 +49,7 @@ static inline void aesdragontamer_seed_r(aesdragontamer_state *state,
   state->increment =
       _mm_set_epi8(0x2f, 0x2b, 0x29, 0x25, 0x1f, 0x1d, 0x17, 0x13, 0x11, 0x0D,
                    0x0B, 0x07, 0x05, 0x03, 0x02, 0x01);
+  memset(state->buffer, 0, sizeof(state->buffer));
   state->offset = 0;
   state->state = _mm_set_epi64x(splitmix64_stateless(seed, 0),
                                 splitmix64_stateless(seed, 1));
@@ -44,12 +57,28 @@ static inline void aesdragontamer_seed_r(aesdragontamer_state *state,
 }
 
 static inline uint64_t aesdragontamer_r(aesdragontamer_state *state) {
-  if (state->offset == 4)
+  if (state->offset == state->length)
     aesdragontamer_tobuffer_r(
         state); // every 4 calls, we generate 4 new uint64_t
   return state->buffer[state->offset++];
 }
 
+// writes the next n words, the same ones that n calls to aesdragontamer_r
+// would return: whole steps go straight to out, bypassing the buffer
+static inline void aesdragontamer_fill_r(aesdragontamer_state *state,
+                                         uint64_t *out, size_t n) {
+  size_t i = 0;
+  while (i < n && state->offset < state->length) {
+    out[i++] = state->buffer[state->offset++];
+  }
+  for (; n - i >= 4; i += 4) {
+    aesdragontamer_step_r(state, out + i);
+  }
+  for (; i < n; i++) {
+    out[i] = aesdragontamer_r(state);
+  }
+}
+
 static aesdragontamer_state g_aesdragontamer_state;
 
 static inline void aesdragontamer_seed(uint64_t seed) {
@@ -60,5 +89,106 @@ static inline uint64_t aesdragontamer() {
   return aesdragontamer_r(&g_aesdragontamer_state);
 }
 
+static inline void aesdragontamer_fill(uint64_t *out, size_t n) {
+  aesdragontamer_fill_r(&g_aesdragontamer_state, out, n);
+}
+
+#if defined(__VAES__) && defined(__AVX512F__)
+#define AESDRAGONTAMER_VAES_LANES 4 // steps per VAES instruction
+#elif defined(__VAES__) && defined(__AVX2__)
+#define AESDRAGONTAMER_VAES_LANES 2
+#endif
+
+#ifdef AESDRAGONTAMER_VAES_LANES
+// aesdragontamer_vaes is aesdragontamer computed with VAES: the state after k
+// steps is state + k * increment, so we compute AESDRAGONTAMER_VAES_LANES
+// steps with each instruction. The output is the same.
+
+// writes the next AESDRAGONTAMER_VAES_LANES steps (4 words each) to out
+static inline void aesdragontamer_vaes_steps_r(aesdragontamer_state *state,
+                                               uint64_t *out) {
+  const __m128i inc = state->increment;
+  const __m128i inc2 = _mm_add_epi64(inc, inc);
+#if AESDRAGONTAMER_VAES_LANES == 4
+  const __m128i inc3 = _mm_add_epi64(inc2, inc);
+  const __m128i inc4 = _mm_add_epi64(inc2, inc2);
+  const __m512i multiples = avx512_inserti64x4(
+      _mm512_castsi256_si512(_mm256_set_m128i(inc2, inc)),
+      _mm256_set_m128i(inc4, inc3), 1);
+  const __m512i increment = avx512_broadcast_i32x4(inc);
+  __m512i x = _mm512_add_epi64(avx512_broadcast_i32x4(state->state), multiples);
+  __m512i penultimate = _mm512_aesenc_epi128(x, increment);
+  __m512i penultimate1 = _mm512_aesenc_epi128(penultimate, increment);
+  __m512i penultimate2 = _mm512_aesdec_epi128(penultimate, increment);
+  // step k writes penultimate1 then penultimate2 (128 bits each)
+  _mm512_storeu_si512(
+      (void *)out,
+      _mm512_permutex2var_epi64(penultimate1,
+                                _mm512_set_epi64(11, 10, 3, 2, 9, 8, 1, 0),
+                                penultimate2));
+  _mm512_storeu_si512(
+      (void *)(out + 8),
+      _mm512_permutex2var_epi64(penultimate1,
+                                _mm512_set_epi64(15, 14, 7, 6, 13, 12, 5, 4),
+                                penultimate2));
+  state->state = _mm_add_epi64(state->state, inc4);
+#else
+  const __m256i multiples = _mm256_set_m128i(inc2, inc);
+  const __m256i increment = _mm256_broadcastsi128_si256(inc);
+  __m256i x = _mm256_add_epi64(_mm256_broadcastsi128_si256(state->state),
+                               multiples);
+  __m256i penultimate = _mm256_aesenc_epi128(x, increment);
+  __m256i penultimate1 = _mm256_aesenc_epi128(penultimate, increment);
+  __m256i penultimate2 = _mm256_aesdec_epi128(penultimate, increment);
+  _mm256_storeu_si256((__m256i *)out, _mm256_permute2x128_si256(
+                                          penultimate1, penultimate2, 0x20));
+  _mm256_storeu_si256(
+      (__m256i *)(out + 4),
+      _mm256_permute2x128_si256(penultimate1, penultimate2, 0x31));
+  state->state = _mm_add_epi64(state->state, inc2);
+#endif
+}
+
+static inline uint64_t aesdragontamer_vaes_r(aesdragontamer_state *state) {
+  if (state->offset == state->length) {
+    aesdragontamer_vaes_steps_r(state, state->buffer);
+    state->offset = 0;
+    state->length = 4 * AESDRAGONTAMER_VAES_LANES;
+  }
+  return state->buffer[state->offset++];
+}
+
+// writes the next n words, the same ones that n calls to aesdragontamer_r
+// would return
+static inline void aesdragontamer_vaes_fill_r(aesdragontamer_state *state,
+                                              uint64_t *out, size_t n) {
+  size_t i = 0;
+  while (i < n && state->offset < state->length) {
+    out[i++] = state->buffer[state->offset++];
+  }
+  for (; n - i >= 4 * AESDRAGONTAMER_VAES_LANES;
+       i += 4 * AESDRAGONTAMER_VAES_LANES) {
+    aesdragontamer_vaes_steps_r(state, out + i);
+  }
+  for (; i < n; i++) {
+    out[i] = aesdragontamer_vaes_r(state);
+  }
+}
+
+static aesdragontamer_state g_aesdragontamer_vaes_state;
+
+static inline void aesdragontamer_vaes_seed(uint64_t seed) {
+  aesdragontamer_seed_r(&g_aesdragontamer_vaes_state, seed);
+}
+
+static inline uint64_t aesdragontamer_vaes() {
+  return aesdragontamer_vaes_r(&g_aesdragontamer_vaes_state);
+}
+
+static inline void aesdragontamer_vaes_fill(uint64_t *out, size_t n) {
+  aesdragontamer_vaes_fill_r(&g_aesdragontamer_vaes_state, out, n);
+}
+#endif // AESDRAGONTAMER_VAES_LANES
+
 #endif // __AES__
 #endif
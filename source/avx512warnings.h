@@ -0,0 +1,44 @@
+#ifndef AVX512WARNINGS_H
+#define AVX512WARNINGS_H
+
+// GCC (up to 12 at least) writes the AVX-512 intrinsics whose result has
+// no merge source (_mm512_slli_epi64, _mm512_srli_epi64, _mm512_rol_epi64,
+// _mm512_broadcast_i32x4, ...) with _mm512_undefined_epi32(), which is
+// `__m512i __Y = __Y;`. g++ reports that self-initialization as
+// -Wuninitialized/-Wmaybe-uninitialized in every function where such an
+// intrinsic is inlined, hundreds of times per translation unit.
+//
+// The AVX-512 sections of the generators use the forms below instead: the
+// zero-masking intrinsic with every lane selected. It compiles to the same
+// instruction (no mask register), and nothing is left undefined, so there
+// is no warning to silence. They are macros, like the intrinsics, because
+// some counts must be immediates.
+
+#if defined(__AVX512F__)
+#define AVX512_ALL8 ((__mmask8)-1)
+#define AVX512_ALL16 ((__mmask16)-1)
+
+#define avx512_slli_epi64(a, k) _mm512_maskz_slli_epi64(AVX512_ALL8, a, k)
+#define avx512_srli_epi64(a, k) _mm512_maskz_srli_epi64(AVX512_ALL8, a, k)
+#define avx512_rol_epi64(a, k) _mm512_maskz_rol_epi64(AVX512_ALL8, a, k)
+#define avx512_mul_epu32(a, b) _mm512_maskz_mul_epu32(AVX512_ALL8, a, b)
+#define avx512_slli_epi32(a, k) _mm512_maskz_slli_epi32(AVX512_ALL16, a, k)
+#define avx512_srli_epi32(a, k) _mm512_maskz_srli_epi32(AVX512_ALL16, a, k)
+#define avx512_srai_epi32(a, k) _mm512_maskz_srai_epi32(AVX512_ALL16, a, k)
+#define avx512_unpacklo_epi32(a, b)                                            \
+  _mm512_maskz_unpacklo_epi32(AVX512_ALL16, a, b)
+#define avx512_unpackhi_epi32(a, b)                                            \
+  _mm512_maskz_unpackhi_epi32(AVX512_ALL16, a, b)
+#define avx512_unpacklo_epi64(a, b)                                            \
+  _mm512_maskz_unpacklo_epi64(AVX512_ALL8, a, b)
+#define avx512_unpackhi_epi64(a, b)                                            \
+  _mm512_maskz_unpackhi_epi64(AVX512_ALL8, a, b)
+#define avx512_shuffle_i32x4(a, b, imm)                                        \
+  _mm512_maskz_shuffle_i32x4(AVX512_ALL16, a, b, imm)
+#define avx512_broadcast_i32x4(a)                                              \
+  _mm512_maskz_broadcast_i32x4(AVX512_ALL16, a)
+#define avx512_inserti64x4(a, b, imm)                                          \
+  _mm512_maskz_inserti64x4(AVX512_ALL8, a, b, imm)
+#endif
+
+#endif // AVX512WARNINGS_H
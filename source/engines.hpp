@@ -0,0 +1,270 @@
+#ifndef ENGINES_HPP
+#define ENGINES_HPP
+
+// C++20 engines around the reentrant state of the generators in this
+// directory. Each one satisfies std::uniform_random_bit_generator, so it
+// works with the <random> distributions and std::shuffle:
+//
+//   testingrng::pcg64_engine engine(42);
+//   std::normal_distribution<double> normal;
+//   double x = normal(engine);
+//
+// An engine is its state and nothing else; seed, operator(), discard and
+// generate call the _seed_r, _r, _discard_r (or _seek_r) and _fill_r
+// functions of the generator, which the compiler inlines.
+// The CG128 generators return 128-bit words, which are not a standard
+// unsigned integral type, so they have no engine.
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <span>
+
+#include "CG64.h"
+#include "jenkinssmall.h"
+#include "lehmer64.h"
+#include "lehmer64x.h"
+#include "mersennetwister.h"
+#include "mitchellmoore.h"
+#include "pcg32.h"
+#include "pcg64.h"
+#include "philox.h"
+#include "splitmix63.h"
+#include "splitmix64.h"
+#include "threefry.h"
+#include "trivium32.h"
+#include "trivium64.h"
+#include "w1rand.h"
+#include "widynski.h"
+#include "wyhash.h"
+#include "wyrand.h"
+#include "wyrandx.h"
+#include "xoroshiro128plus.h"
+#include "xorshift-k4.h"
+#include "xorshift-k5.h"
+#include "xorshift1024plus.h"
+#include "xorshift1024star.h"
+#include "xorshift128plus.h"
+#include "xorshift32.h"
+#ifdef __AES__
+#include "aesctr.h"
+#include "aesdragontamer.h"
+#endif
+#ifdef __AVX2__
+#include "simdtrivium64.h"
+#include "simdxoroshiro128plus.h"
+#include "simdxorshift128plus.h"
+#endif
+
+namespace testingrng {
+
+// State: the state of the generator; seed_fn(State *, uint64_t),
+// next_fn(State *) and fill_fn(State *, result_type *, size_t) are its
+// reentrant functions. discard_fn(State *, unsigned long long), when given,
+// skips values faster than calling next_fn. bits is the width of the
+// output when it is narrower than result_type (splitmix63).
+template <typename State, auto seed_fn, auto next_fn, auto fill_fn,
+          auto discard_fn = nullptr, unsigned bits = 0>
+class engine {
+public:
+  using result_type = decltype(next_fn(static_cast<State *>(nullptr)));
+  static constexpr uint64_t default_seed = 12345678;
+
+  engine() { seed(default_seed); }
+  explicit engine(uint64_t value) { seed(value); }
+
+  void seed(uint64_t value = default_seed) { seed_fn(&state_, value); }
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() {
+    if constexpr (bits == 0) {
+      return std::numeric_limits<result_type>::max();
+    } else {
+      return result_type((result_type(1) << bits) - 1);
+    }
+  }
+
+  result_type operator()() { return next_fn(&state_); }
+
+  // writes out.size() values, the same ones as that many calls
+  void generate(std::span<result_type> out) {
+    fill_fn(&state_, out.data(), out.size());
+  }
+
+  void discard(unsigned long long n) {
+    if constexpr (std::is_same_v<decltype(discard_fn), std::nullptr_t>) {
+      for (; n != 0; n--) next_fn(&state_);
+    } else {
+      discard_fn(&state_, n);
+    }
+  }
+
+  State &state() { return state_; }
+  const State &state() const { return state_; }
+
+private:
+  State state_;
+};
+
+namespace detail {
+
+// the generators seeded with something besides a seed
+inline void trivium32_seed(trivium32_state *state, uint64_t seed) {
+  trivium32_seed_r(state, seed, 0);
+}
+
+inline void trivium64_seed(trivium64_state *state, uint64_t seed) {
+  trivium64_seed_r(state, seed, 0);
+}
+
+inline void lehmer64x_seed(lehmer64x_state *state, uint64_t seed) {
+  lehmer64x_seed_r(state, seed, LEHMER64X_LANES);
+}
+
+inline void wyrandx_seed(wyrandx_state *state, uint64_t seed) {
+  wyrandx_seed_r(state, seed, WYRANDX_LANES);
+}
+
+#ifdef __AVX2__
+inline void simdtrivium64_seed(simdtrivium64_state *state, uint64_t seed) {
+  simdtrivium64_seed_r(state, seed, 0);
+}
+#endif
+
+inline void pcg32_discard(pcg32_random_t *rng, unsigned long long n) {
+  pcg32_discard_r(rng, n);
+}
+
+inline void pcg64_discard(pcg64_random_t *rng, unsigned long long n) {
+  pcg64_discard_r(rng, n);
+}
+
+inline void lehmer64_discard(__uint128_t *state, unsigned long long n) {
+  lehmer64_discard_r(state, n);
+}
+
+// the counter-based generators are at word counter * W - W + offset, where
+// W is the number of words per block (the formula also holds after seeding,
+// with counter 0 and offset W)
+template <typename State, auto seek_fn>
+inline void counter_discard(State *state, unsigned long long n) {
+  constexpr uint64_t words = sizeof(state->buffer) / sizeof(state->buffer[0]);
+  const uint64_t position = state->counter * words - words + state->offset;
+  seek_fn(state, position + n);
+}
+
+} // namespace detail
+
+// 32-bit engines
+using trivium32_engine = engine<trivium32_state, detail::trivium32_seed,
+                                trivium32_r, trivium32_fill_r>;
+using xorshift_k4_engine = engine<xorshift_k4_state, xorshift_k4_seed_r,
+                                  xorshift_k4_r, xorshift_k4_fill_r>;
+using xorshift_k5_engine = engine<xorshift_k5_state, xorshift_k5_seed_r,
+                                  xorshift_k5_r, xorshift_k5_fill_r>;
+using mersennetwister_engine =
+    engine<mersennetwister_state, mersennetwister_seed_r, mersennetwister_r,
+           mersennetwister_fill_r>;
+using mitchellmoore_engine = engine<mitchellmoore_state, mitchellmoore_seed_r,
+                                    mitchellmoore_r, mitchellmoore_fill_r>;
+using widynski_engine =
+    engine<widynski_state, widynski_seed_r, widynski_r, widynski_fill_r>;
+using xorshift32_engine = engine<unsigned int, xorshift32_seed_r,
+                                 xorshift32_r, xorshift32_fill_r>;
+using pcg32_engine = engine<pcg32_random_t, pcg32_seed_r, pcg32_r,
+                            pcg32_fill_r, detail::pcg32_discard>;
+
+// 64-bit engines
+using trivium64_engine = engine<trivium64_state, detail::trivium64_seed,
+                                trivium64_r, trivium64_fill_r>;
+using lehmer64_engine = engine<__uint128_t, lehmer64_seed_r, lehmer64_r,
+                               lehmer64_fill_r, detail::lehmer64_discard>;
+using lehmer64x_engine = engine<lehmer64x_state, detail::lehmer64x_seed,
+                                lehmer64x_r, lehmer64x_fill_r>;
+using xorshift128plus_engine =
+    engine<xorshift128plus_key_t, xorshift128plus_seed_r, xorshift128plus_r,
+           xorshift128plus_fill_r>;
+using v8xorshift128plus_engine =
+    engine<xorshift128plus_key_t, v8xorshift128plus_seed_r,
+           v8xorshift128plus_r, v8xorshift128plus_fill_r>;
+using xoroshiro128plus_engine =
+    engine<xoroshiro128plus_state, xoroshiro128plus_seed_r,
+           xoroshiro128plus_r, xoroshiro128plus_fill_r>;
+using splitmix64_engine =
+    engine<uint64_t, splitmix64_seed_r, splitmix64_r, splitmix64_fill_r>;
+using splitmix63_engine = engine<uint64_t, splitmix63_seed_r, splitmix63_r,
+                                 splitmix63_fill_r, nullptr, 63>;
+using pcg64_engine = engine<pcg64_random_t, pcg64_seed_r, pcg64_r,
+                            pcg64_fill_r, detail::pcg64_discard>;
+using xorshift1024star_engine =
+    engine<xorshift1024star_state, xorshift1024star_seed_r,
+           xorshift1024star_r, xorshift1024star_fill_r>;
+using xorshift1024plus_engine =
+    engine<xorshift1024plus_state, xorshift1024plus_seed_r,
+           xorshift1024plus_r, xorshift1024plus_fill_r>;
+using wyhash64_engine =
+    engine<uint64_t, wyhash64_seed_r, wyhash64_r, wyhash64_fill_r>;
+using wyrand_engine = engine<uint64_t, wyrand_seed_r, wyrand_r, wyrand_fill_r>;
+using wyrandx_engine = engine<wyrandx_state, detail::wyrandx_seed, wyrandx_r,
+                              wyrandx_fill_r>;
+using w1rand_engine = engine<uint64_t, w1rand_seed_r, w1rand_r, w1rand_fill_r>;
+using jenkinssmall_engine =
+    engine<jenkinssmall_ranctx, jenkinssmall_seed_r, jenkinssmall_r,
+           jenkinssmall_fill_r>;
+using philox4x32_engine =
+    engine<philox4x32_state, philox4x32_seed_r, philox4x32_r,
+           philox4x32_fill_r,
+           detail::counter_discard<philox4x32_state, philox4x32_seek_r>>;
+using philox4x64_engine =
+    engine<philox4x64_state, philox4x64_seed_r, philox4x64_r,
+           philox4x64_fill_r,
+           detail::counter_discard<philox4x64_state, philox4x64_seek_r>>;
+using threefry2x64_engine =
+    engine<threefry2x64_state, threefry2x64_seed_r, threefry2x64_r,
+           threefry2x64_fill_r,
+           detail::counter_discard<threefry2x64_state, threefry2x64_seek_r>>;
+using threefry4x64_engine =
+    engine<threefry4x64_state, threefry4x64_seed_r, threefry4x64_r,
+           threefry4x64_fill_r,
+           detail::counter_discard<threefry4x64_state, threefry4x64_seek_r>>;
+using CG64_engine = engine<CG64_state, CG64_seed_r, CG64_r, CG64_fill_r>;
+
+#ifdef __AES__
+using aesctr_engine =
+    engine<aesctr_state, aesctr_seed_r, aesctr_r, aesctr_fill_r>;
+using aesdragontamer_engine =
+    engine<aesdragontamer_state, aesdragontamer_seed_r, aesdragontamer_r,
+           aesdragontamer_fill_r>;
+#ifdef AESCTR_VAES_LANES
+using aesctr_vaes_engine =
+    engine<aesctr_state, aesctr_seed_r, aesctr_vaes_r, aesctr_vaes_fill_r>;
+#endif
+#ifdef AESDRAGONTAMER_VAES_LANES
+using aesdragontamer_vaes_engine =
+    engine<aesdragontamer_state, aesdragontamer_seed_r, aesdragontamer_vaes_r,
+           aesdragontamer_vaes_fill_r>;
+#endif
+#endif
+
+#ifdef __AVX2__
+using simdxorshift128plus_engine =
+    engine<simdxorshift128plus_state, simdxorshift128plus_seed_r,
+           simdxorshift128plus_r, simdxorshift128plus_fill_r>;
+using simdxoroshiro128plus_engine =
+    engine<simdxoroshiro128plus_state, simdxoroshiro128plus_seed_r,
+           simdxoroshiro128plus_r, simdxoroshiro128plus_fill_r>;
+using simdtrivium64_engine =
+    engine<simdtrivium64_state, detail::simdtrivium64_seed, simdtrivium64_r,
+           simdtrivium64_fill_r>;
+#endif
+
+static_assert(std::uniform_random_bit_generator<pcg32_engine>);
+static_assert(std::uniform_random_bit_generator<pcg64_engine>);
+static_assert(std::uniform_random_bit_generator<splitmix63_engine>);
+static_assert(splitmix63_engine::max() == UINT64_C(0x7fffffffffffffff));
+
+} // namespace testingrng
+
+#endif // ENGINES_HPP
@@ -0,0 +1,26 @@
+#ifndef FILL_H
+#define FILL_H
+
+#include <stddef.h>
+
+// Every generator NAME has a bulk fill next to NAME_r and NAME():
+//   NAME_fill_r(state, out, n) writes the next n values of the stream to
+//   out, the same ones that n calls to NAME_r would have returned;
+//   NAME_fill(out, n) does the same on the global state.
+// out has the word type of the generator: uint64_t for the 64-bit
+// generators, uint32_t for the 32-bit ones (and __uint128_t for CG128).
+// Generators that compute several values at once or keep a buffer of
+// outputs write their own fill; the others use the loop below, which the
+// compiler can inline and unroll around NAME_r.
+#define FILL_GENERIC(name, state_type, word_type, global_state)              \
+  static inline void name##_fill_r(state_type *state, word_type *out,         \
+                                   size_t n) {                                \
+    for (size_t i = 0; i < n; i++) {                                          \
+      out[i] = name##_r(state);                                               \
+    }                                                                         \
+  }                                                                           \
+  static inline void name##_fill(word_type *out, size_t n) {                  \
+    name##_fill_r(&(global_state), out, n);                                   \
+  }
+
+#endif // FILL_H
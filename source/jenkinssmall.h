@@ -5,6 +5,7 @@
 
 #include "splitmix64.h"
 #include <stdint.h>
+#include "fill.h"
 
 typedef struct jenkinssmall_ranctx {
   uint64_t a;
@@ -17,24 +18,29 @@ static jenkinssmall_ranctx jenkinssmall_y;
 
 #define rot(x, k) (((x) << (k)) | ((x) >> (64 - (k))))
 
-uint64_t jenkinssmall(void) {
-  uint64_t e = jenkinssmall_y.a - rot(jenkinssmall_y.b, 7);
-  jenkinssmall_y.a = jenkinssmall_y.b ^ rot(jenkinssmall_y.c, 13);
-  jenkinssmall_y.b = jenkinssmall_y.c + rot(jenkinssmall_y.d, 37);
-  jenkinssmall_y.c = jenkinssmall_y.d + e;
-  jenkinssmall_y.d = e + jenkinssmall_y.a;
-  return jenkinssmall_y.d;
+static inline uint64_t jenkinssmall_r(jenkinssmall_ranctx *x) {
+  uint64_t e = x->a - rot(x->b, 7);
+  x->a = x->b ^ rot(x->c, 13);
+  x->b = x->c + rot(x->d, 37);
+  x->c = x->d + e;
+  x->d = e + x->a;
+  return x->d;
 }
 
 #undef rot
 
-void jenkinssmall_init(uint64_t seed) {
+static inline void jenkinssmall_seed_r(jenkinssmall_ranctx *x, uint64_t seed) {
   uint64_t i;
-  jenkinssmall_y.a = 0xf1ea5eed,
-  jenkinssmall_y.b = jenkinssmall_y.c = jenkinssmall_y.d = seed;
+  x->a = 0xf1ea5eed, x->b = x->c = x->d = seed;
   for (i = 0; i < 20; ++i) {
-    (void)jenkinssmall();
+    (void)jenkinssmall_r(x);
   }
 }
 
+static inline uint64_t jenkinssmall(void) { return jenkinssmall_r(&jenkinssmall_y); }
+
+static inline void jenkinssmall_init(uint64_t seed) { jenkinssmall_seed_r(&jenkinssmall_y, seed); }
+
+FILL_GENERIC(jenkinssmall, jenkinssmall_ranctx, uint64_t, jenkinssmall_y)
+
 #endif
@@ -2,6 +2,7 @@
 #define LEHMER64_H
 
 #include "splitmix64.h"
+#include "fill.h"
 
 static __uint128_t g_lehmer64_state;
 
@@ -17,14 +18,45 @@ static __uint128_t g_lehmer64_state;
 * Society 68.225 (1999): 249-260.
 */
 
+// the state of lehmer64 is a single 128-bit word
+static inline void lehmer64_seed_r(__uint128_t *state, uint64_t seed) {
+  *state = (((__uint128_t)splitmix64_stateless(seed, 0)) << 64) +
+           splitmix64_stateless(seed, 1);
+}
+
+static inline uint64_t lehmer64_r(__uint128_t *state) {
+  *state *= UINT64_C(0xda942042e4dd58b5);
+  return *state >> 64;
+}
+
+// Jumps ahead by delta steps in O(log delta) time: the state is multiplied
+// by the multiplier to the power delta, by square-and-multiply.
+static inline void lehmer64_advance_r(__uint128_t *state, __uint128_t delta) {
+  __uint128_t cur_mult = UINT64_C(0xda942042e4dd58b5);
+  __uint128_t acc_mult = 1u;
+  while (delta > 0) {
+    if (delta & 1) acc_mult *= cur_mult;
+    cur_mult *= cur_mult;
+    delta /= 2;
+  }
+  *state *= acc_mult;
+}
+
+// skips the next n outputs, as n calls to lehmer64_r would
+static inline void lehmer64_discard_r(__uint128_t *state, __uint128_t n) {
+  lehmer64_advance_r(state, n);
+}
+
 static inline void lehmer64_seed(uint64_t seed) {
-  g_lehmer64_state = (((__uint128_t)splitmix64_stateless(seed, 0)) << 64) +
-                     splitmix64_stateless(seed, 1);
+  lehmer64_seed_r(&g_lehmer64_state, seed);
 }
 
-static inline uint64_t lehmer64() {
-  g_lehmer64_state *= UINT64_C(0xda942042e4dd58b5);
-  return g_lehmer64_state >> 64;
+static inline uint64_t lehmer64() { return lehmer64_r(&g_lehmer64_state); }
+
+static inline void lehmer64_advance(__uint128_t delta) {
+  lehmer64_advance_r(&g_lehmer64_state, delta);
 }
 
+FILL_GENERIC(lehmer64, __uint128_t, uint64_t, g_lehmer64_state)
+
 #endif
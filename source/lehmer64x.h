@@ -0,0 +1,127 @@
+#ifndef LEHMER64X_H
+#define LEHMER64X_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "lehmer64.h"
+
+// Interleaved lehmer64: 2, 4 or 8 separately seeded lehmer64 generators
+// advance in lockstep. Each lehmer64 step waits for the previous 128-bit
+// product, so a single stream leaves the multiplier idle most of the time;
+// with several streams, the multiplications overlap. The resulting stream
+// interleaves the lanes (out[0] is lane 0, out[1] is lane 1, ...) and every
+// lane is exactly lehmer64_r on its own state.
+
+#define LEHMER64X_MAX_LANES 8
+
+// number of lanes of the global generator (2, 4 or 8)
+#ifndef LEHMER64X_LANES
+#define LEHMER64X_LANES 4
+#endif
+
+typedef struct {
+  __uint128_t s[LEHMER64X_MAX_LANES];
+  // outputs not yet handed out by lehmer64x_r
+  uint64_t buffer[LEHMER64X_MAX_LANES];
+  size_t offset;
+  size_t lanes;
+} lehmer64x_state;
+
+static lehmer64x_state g_lehmer64x_state;
+
+// Each lane is seeded on its own, from splitmix64 of (seed, lane), with its
+// state forced odd. Lanes must not be spaced by powers of two along the
+// period: i * 2^k steps multiply the state by a^(i * 2^k), which is 1
+// modulo 2^(k+2), so such lanes differ only in their top bits.
+static inline void lehmer64x_seed_r(lehmer64x_state *state, uint64_t seed,
+                                    size_t lanes) {
+  state->lanes = (lanes == 2 || lanes == 4) ? lanes : LEHMER64X_MAX_LANES;
+  for (size_t i = 0; i < state->lanes; i++) {
+    lehmer64_seed_r(&state->s[i], splitmix64_stateless(seed, i));
+    state->s[i] |= 1;
+  }
+  state->offset = state->lanes;
+}
+
+// advances every lane once, writes one output per lane
+static inline __attribute__((always_inline)) void
+lehmer64x_step_r(lehmer64x_state *state, uint64_t *out, size_t lanes) {
+  for (size_t j = 0; j < lanes; j++) {
+    out[j] = lehmer64_r(&state->s[j]);
+  }
+}
+
+static inline void lehmer64x_refill_r(lehmer64x_state *state) {
+  switch (state->lanes) {
+  case 2:
+    lehmer64x_step_r(state, state->buffer, 2);
+    break;
+  case 4:
+    lehmer64x_step_r(state, state->buffer, 4);
+    break;
+  default:
+    lehmer64x_step_r(state, state->buffer, 8);
+    break;
+  }
+  state->offset = 0;
+}
+
+// returns random number, one lane at a time
+static inline uint64_t lehmer64x_r(lehmer64x_state *state) {
+  if (__builtin_expect(state->offset >= state->lanes, 0)) {
+    lehmer64x_refill_r(state);
+  }
+  return state->buffer[state->offset++];
+}
+
+// writes whole steps straight to out; the state copy lives in registers
+static inline __attribute__((always_inline)) size_t
+lehmer64x_fill_lanes_r(lehmer64x_state *state, uint64_t *out, size_t n,
+                       size_t lanes) {
+  lehmer64x_state copy = *state;
+  size_t i = 0;
+  for (; i + lanes <= n; i += lanes) {
+    lehmer64x_step_r(&copy, out + i, lanes);
+  }
+  for (size_t j = 0; j < lanes; j++) state->s[j] = copy.s[j];
+  return i;
+}
+
+// writes the next n values of the stream, the same ones that n calls to
+// lehmer64x_r would have returned
+static inline void lehmer64x_fill_r(lehmer64x_state *state, uint64_t *out,
+                                    size_t n) {
+  size_t i = 0;
+  while (i < n && state->offset < state->lanes) {
+    out[i++] = state->buffer[state->offset++];
+  }
+  switch (state->lanes) {
+  case 2:
+    i += lehmer64x_fill_lanes_r(state, out + i, n - i, 2);
+    break;
+  case 4:
+    i += lehmer64x_fill_lanes_r(state, out + i, n - i, 4);
+    break;
+  default:
+    i += lehmer64x_fill_lanes_r(state, out + i, n - i, 8);
+    break;
+  }
+  for (; i < n; i++) {
+    out[i] = lehmer64x_r(state);
+  }
+}
+
+static inline void lehmer64x_seed(uint64_t seed) {
+  lehmer64x_seed_r(&g_lehmer64x_state, seed, LEHMER64X_LANES);
+}
+
+static inline uint64_t lehmer64x(void) {
+  return lehmer64x_r(&g_lehmer64x_state);
+}
+
+static inline void lehmer64x_fill(uint64_t *out, size_t n) {
+  lehmer64x_fill_r(&g_lehmer64x_state, out, n);
+}
+
+#endif // LEHMER64X_H
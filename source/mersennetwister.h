@@ -3,7 +3,13 @@
 
 // adapted from code by Piotr Stefaniak
 
+#include <stddef.h>
 #include <stdint.h>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "avx512warnings.h"
 
 /*
    A C-program for MT19937, with initialization improved 2002/1/26.
@@ -53,73 +59,186 @@
 #define UPPER_MASK 0x80000000UL /* most significant w-r bits */
 #define LOWER_MASK 0x7fffffffUL /* least significant r bits */
 
-static uint32_t mersennetwister_mt[N]; /* the array for the state vector  */
-static unsigned int mersennetwister_mti =
-    N + 1; /* mersennetwister_mti==N+1 means mersennetwister_mt[N] is not
-              initialized */
-
-/* initializes mersennetwister_mt[N] with a seed */
-static inline void mersennetwister_seed(uint64_t seed) {
-  mersennetwister_mt[0] = seed & 0xffffffffUL;
-  for (mersennetwister_mti = 1; mersennetwister_mti < N;
-       mersennetwister_mti++) {
-    mersennetwister_mt[mersennetwister_mti] =
-        (1812433253UL * (mersennetwister_mt[mersennetwister_mti - 1] ^
-                         (mersennetwister_mt[mersennetwister_mti - 1] >> 30)) +
-         mersennetwister_mti);
+typedef struct {
+  uint32_t mt[N];  /* the array for the state vector  */
+  unsigned int mti; /* mti==N+1 means mt[N] is not initialized */
+} mersennetwister_state;
+
+static mersennetwister_state g_mersennetwister_state = {{0}, N + 1};
+
+/* initializes state->mt[N] with a seed */
+static inline void mersennetwister_seed_r(mersennetwister_state *state,
+                                          uint64_t seed) {
+  uint32_t *mt = state->mt;
+  mt[0] = seed & 0xffffffffUL;
+  for (state->mti = 1; state->mti < N; state->mti++) {
+    mt[state->mti] =
+        (1812433253UL * (mt[state->mti - 1] ^ (mt[state->mti - 1] >> 30)) +
+         state->mti);
     /* See Knuth TAOCP Vol2. 3rd Ed. P.106 for multiplier. */
     /* In the previous versions, MSBs of the seed affect   */
-    /* only MSBs of the array mersennetwister_mt[].                        */
+    /* only MSBs of the array mt[].                        */
     /* 2002/01/09 modified by Makoto Matsumoto             */
-    mersennetwister_mt[mersennetwister_mti] &= 0xffffffffUL;
+    mt[state->mti] &= 0xffffffffUL;
     /* for >32 bit machines */
   }
 }
 
-/* generates a random number on [0,0xffffffff]-interval */
-static inline uint32_t mersennetwister(void) {
-  uint32_t y;
-
-  if (mersennetwister_mti >= N) { /* generate N words at one time */
-    static uint32_t mag01[2] = {0x0UL, MATRIX_A};
-    /* mag01[x] = x * MATRIX_A  for x=0,1 */
-    int kk;
-
-    for (kk = 0; kk < N - M; kk++) {
-      y = (mersennetwister_mt[kk] & UPPER_MASK) |
-          (mersennetwister_mt[kk + 1] & LOWER_MASK);
-      mersennetwister_mt[kk] =
-          mersennetwister_mt[kk + M] ^ (y >> 1) ^ mag01[y & 0x1UL];
-    }
-    for (; kk < N - 1; kk++) {
-      y = (mersennetwister_mt[kk] & UPPER_MASK) |
-          (mersennetwister_mt[kk + 1] & LOWER_MASK);
-      mersennetwister_mt[kk] =
-          mersennetwister_mt[kk + (M - N)] ^ (y >> 1) ^ mag01[y & 0x1UL];
-    }
-    y = (mersennetwister_mt[N - 1] & UPPER_MASK) |
-        (mersennetwister_mt[0] & LOWER_MASK);
-    mersennetwister_mt[N - 1] =
-        mersennetwister_mt[M - 1] ^ (y >> 1) ^ mag01[y & 0x1UL];
+#if defined(__AVX512F__)
+#define MT_LANES 16
+typedef __m512i mt_vec;
+#define mt_load(p) _mm512_loadu_si512((const void *)(p))
+#define mt_store(p, v) _mm512_storeu_si512((void *)(p), v)
+#define mt_set1(x) _mm512_set1_epi32((int)(x))
+#define mt_and(a, b) _mm512_and_si512(a, b)
+#define mt_or(a, b) _mm512_or_si512(a, b)
+#define mt_xor(a, b) _mm512_xor_si512(a, b)
+#define mt_slli(a, k) avx512_slli_epi32(a, k)
+#define mt_srli(a, k) avx512_srli_epi32(a, k)
+#define mt_srai(a, k) avx512_srai_epi32(a, k)
+#elif defined(__AVX2__)
+#define MT_LANES 8
+typedef __m256i mt_vec;
+#define mt_load(p) _mm256_loadu_si256((const __m256i *)(p))
+#define mt_store(p, v) _mm256_storeu_si256((__m256i *)(p), v)
+#define mt_set1(x) _mm256_set1_epi32((int)(x))
+#define mt_and(a, b) _mm256_and_si256(a, b)
+#define mt_or(a, b) _mm256_or_si256(a, b)
+#define mt_xor(a, b) _mm256_xor_si256(a, b)
+#define mt_slli(a, k) _mm256_slli_epi32(a, k)
+#define mt_srli(a, k) _mm256_srli_epi32(a, k)
+#define mt_srai(a, k) _mm256_srai_epi32(a, k)
+#endif
 
-    mersennetwister_mti = 0;
-  }
+/* new value of mt[kk], given mt[kk], mt[kk + 1] and mt[kk + M] (mod N) */
+static inline uint32_t mersennetwister_twist(uint32_t u, uint32_t v,
+                                             uint32_t m) {
+  uint32_t y = (u & UPPER_MASK) | (v & LOWER_MASK);
+  /* -(y & 1) & MATRIX_A is mag01[y & 1], without the table lookup */
+  return m ^ (y >> 1) ^ ((0 - (y & 0x1UL)) & MATRIX_A);
+}
 
-  y = mersennetwister_mt[mersennetwister_mti++];
+#ifdef MT_LANES
+/* same as mersennetwister_twist, on MT_LANES consecutive words */
+static inline void mersennetwister_twist_vec(uint32_t *mt, int kk, int m) {
+  mt_vec y = mt_or(mt_and(mt_load(mt + kk), mt_set1(UPPER_MASK)),
+                   mt_and(mt_load(mt + kk + 1), mt_set1(LOWER_MASK)));
+  /* the low bit of y, broadcast to the whole word, selects MATRIX_A */
+  mt_vec mag = mt_and(mt_srai(mt_slli(y, 31), 31), mt_set1(MATRIX_A));
+  mt_store(mt + kk, mt_xor(mt_xor(mt_load(mt + m), mt_srli(y, 1)), mag));
+}
+
+static inline mt_vec mersennetwister_temper_vec(mt_vec y) {
+  y = mt_xor(y, mt_srli(y, 11));
+  y = mt_xor(y, mt_and(mt_slli(y, 7), mt_set1(0x9d2c5680UL)));
+  y = mt_xor(y, mt_and(mt_slli(y, 15), mt_set1(0xefc60000UL)));
+  return mt_xor(y, mt_srli(y, 18));
+}
+#endif
+
+/* generates the next N words of the state at one time */
+static inline void mersennetwister_regenerate(mersennetwister_state *state) {
+  uint32_t *mt = state->mt;
+  int kk = 0;
+  /* mt[kk + M] has not been regenerated yet for kk < N - M, and beyond that
+     mt[kk + M - N] has already been regenerated: as long as we do not cross
+     N - M, a vector of consecutive words only depends on words outside of
+     it, since MT_LANES < N - M */
+#ifdef MT_LANES
+  for (; kk + MT_LANES <= N - M; kk += MT_LANES) {
+    mersennetwister_twist_vec(mt, kk, kk + M);
+  }
+#endif
+  for (; kk < N - M; kk++) {
+    mt[kk] = mersennetwister_twist(mt[kk], mt[kk + 1], mt[kk + M]);
+  }
+#ifdef MT_LANES
+  for (; kk + MT_LANES <= N - 1; kk += MT_LANES) {
+    mersennetwister_twist_vec(mt, kk, kk + (M - N));
+  }
+#endif
+  for (; kk < N - 1; kk++) {
+    mt[kk] = mersennetwister_twist(mt[kk], mt[kk + 1], mt[kk + (M - N)]);
+  }
+  mt[N - 1] = mersennetwister_twist(mt[N - 1], mt[0], mt[M - 1]);
+  state->mti = 0;
+}
 
-  /* Tempering */
+static inline uint32_t mersennetwister_temper(uint32_t y) {
   y ^= (y >> 11);
   y ^= (y << 7) & 0x9d2c5680UL;
   y ^= (y << 15) & 0xefc60000UL;
   y ^= (y >> 18);
-
   return y;
 }
 
+/* generates a random number on [0,0xffffffff]-interval */
+static inline uint32_t mersennetwister_r(mersennetwister_state *state) {
+  if (state->mti >= N) {
+    mersennetwister_regenerate(state);
+  }
+  return mersennetwister_temper(state->mt[state->mti++]);
+}
+
+/* writes the next n numbers, the same ones that n calls to
+   mersennetwister_r would return: whole blocks of N words are regenerated
+   and tempered straight into out */
+static inline void mersennetwister_fill_r(mersennetwister_state *state,
+                                          uint32_t *out, size_t n) {
+  const uint32_t *mt = state->mt;
+  size_t i = 0;
+  while (i < n) {
+    if (state->mti >= N) {
+      mersennetwister_regenerate(state);
+    }
+    size_t count = N - state->mti;
+    if (count > n - i) {
+      count = n - i;
+    }
+    size_t k = 0;
+#ifdef MT_LANES
+    for (; k + MT_LANES <= count; k += MT_LANES) {
+      mt_store(out + i + k,
+               mersennetwister_temper_vec(mt_load(mt + state->mti + k)));
+    }
+#endif
+    for (; k < count; k++) {
+      out[i + k] = mersennetwister_temper(mt[state->mti + k]);
+    }
+    state->mti += count;
+    i += count;
+  }
+}
+
+/* initializes the global state with a seed */
+static inline void mersennetwister_seed(uint64_t seed) {
+  mersennetwister_seed_r(&g_mersennetwister_state, seed);
+}
+
+static inline uint32_t mersennetwister(void) {
+  return mersennetwister_r(&g_mersennetwister_state);
+}
+
+static inline void mersennetwister_fill(uint32_t *out, size_t n) {
+  mersennetwister_fill_r(&g_mersennetwister_state, out, n);
+}
+
 #undef N
 #undef M
 #undef MATRIX_A
 #undef UPPER_MASK
 #undef LOWER_MASK
+#ifdef MT_LANES
+#undef MT_LANES
+#undef mt_load
+#undef mt_store
+#undef mt_set1
+#undef mt_and
+#undef mt_or
+#undef mt_xor
+#undef mt_slli
+#undef mt_srli
+#undef mt_srai
+#endif
 
 #endif
@@ -4,6 +4,7 @@
 // adapted from code by Piotr Stefaniak
 
 #include <stdint.h>
+#include "fill.h"
 
 /* Mitchell-Moore algorithm from
  * "The Art of Computer Programming, Volume II"
@@ -18,29 +19,48 @@
 #define T 103U
 #define U 50U
 
-static uint32_t mitchellmoore_sequence[R];
-static unsigned int mitchellmoore_a = R, mitchellmoore_b = S,
-                    mitchellmoore_c = T, mitchellmoore_d = U;
+typedef struct {
+  uint32_t sequence[R];
+  unsigned int a, b, c, d;
+} mitchellmoore_state;
 
-static inline void mitchellmoore_seed(uint64_t seed) {
+static mitchellmoore_state g_mitchellmoore_state = {{0}, R, S, T, U};
+
+static inline void mitchellmoore_seed_r(mitchellmoore_state *state,
+                                        uint64_t seed) {
   unsigned int i;
 
   for (i = 0; i < R * 2; i++)
-    mitchellmoore_sequence[i % R] = seed = (1664525 * seed + 1013904223);
+    state->sequence[i % R] = seed = (1664525 * seed + 1013904223);
 
-  mitchellmoore_sequence[0] <<= 1;
-  mitchellmoore_sequence[1] |= 1;
+  state->sequence[0] <<= 1;
+  state->sequence[1] |= 1;
+  state->a = R;
+  state->b = S;
+  state->c = T;
+  state->d = U;
 
   return;
 }
 
+static inline uint32_t mitchellmoore_r(mitchellmoore_state *state) {
+  return state->sequence[++state->a % R] +=
+         state->sequence[++state->b % R] +=
+         state->sequence[++state->c % R] +=
+         state->sequence[++state->d % R];
+}
+
+static inline void mitchellmoore_seed(uint64_t seed) {
+  mitchellmoore_seed_r(&g_mitchellmoore_state, seed);
+}
+
 static inline uint32_t mitchellmoore(void) {
-  return mitchellmoore_sequence[++mitchellmoore_a % R] +=
-         mitchellmoore_sequence[++mitchellmoore_b % R] +=
-         mitchellmoore_sequence[++mitchellmoore_c % R] +=
-         mitchellmoore_sequence[++mitchellmoore_d % R];
+  return mitchellmoore_r(&g_mitchellmoore_state);
 }
 
+FILL_GENERIC(mitchellmoore, mitchellmoore_state, uint32_t,
+             g_mitchellmoore_state)
+
 #undef R
 #undef S
 #undef T
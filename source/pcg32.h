@@ -4,6 +4,7 @@
 /* Modified by D. Lemire based on original code by M. O'Neill, August 2017 */
 #include "splitmix64.h"
 #include <stdint.h>
+#include "fill.h"
 
 struct pcg_state_setseq_64 {
   uint64_t
@@ -18,11 +19,51 @@ typedef struct pcg_state_setseq_64 pcg32_random_t;
 static pcg32_random_t pcg32_global; // global state
 
 // call this once before calling pcg32_random_r
-static inline void pcg32_seed(uint64_t seed) {
-  pcg32_global.state = splitmix64_r(&seed);
+static inline void pcg32_seed_r(pcg32_random_t *rng, uint64_t seed) {
+  rng->state = splitmix64_r(&seed);
   // we pick a sequence at random
-  pcg32_global.inc =
-      (splitmix64_r(&seed)) | 1; // making sure it is odd
+  rng->inc = (splitmix64_r(&seed)) | 1; // making sure it is odd
+}
+
+// Seeds the generator on the stream (increment) selected by stream_id, as
+// O'Neill's pcg32_srandom_r does. Generators seeded alike on distinct
+// streams produce distinct sequences; stream ids differing only in their
+// most significant bit select the same stream.
+static inline void pcg32_seed_stream_r(pcg32_random_t *rng, uint64_t seed,
+                                       uint64_t stream_id) {
+  rng->state = 0U;
+  rng->inc = (stream_id << 1u) | 1u;
+  rng->state = rng->state * UINT64_C(0x5851f42d4c957f2d) + rng->inc;
+  rng->state += splitmix64_r(&seed);
+  rng->state = rng->state * UINT64_C(0x5851f42d4c957f2d) + rng->inc;
+}
+
+// seeds the global state
+static inline void pcg32_seed(uint64_t seed) { pcg32_seed_r(&pcg32_global, seed); }
+
+// Jumps ahead by delta steps in O(log delta) time (Brown, "Random Number
+// Generation with Arbitrary Stride", 1994). The period is 2^64 so that
+// advancing by -delta goes back.
+static inline void pcg32_advance_r(pcg32_random_t *rng, uint64_t delta) {
+  uint64_t cur_mult = UINT64_C(0x5851f42d4c957f2d);
+  uint64_t cur_plus = rng->inc;
+  uint64_t acc_mult = 1u;
+  uint64_t acc_plus = 0u;
+  while (delta > 0) {
+    if (delta & 1) {
+      acc_mult *= cur_mult;
+      acc_plus = acc_plus * cur_mult + cur_plus;
+    }
+    cur_plus = (cur_mult + 1) * cur_plus;
+    cur_mult *= cur_mult;
+    delta /= 2;
+  }
+  rng->state = acc_mult * rng->state + acc_plus;
+}
+
+// skips the next n outputs, as n calls to pcg32_random_r would
+static inline void pcg32_discard_r(pcg32_random_t *rng, uint64_t n) {
+  pcg32_advance_r(rng, n);
 }
 
 static inline uint32_t pcg32_random_r(pcg32_random_t *rng) {
@@ -33,6 +74,15 @@ static inline uint32_t pcg32_random_r(pcg32_random_t *rng) {
   return (xorshifted >> rot) | (xorshifted << (32 - rot));
 }
 
+// same as pcg32_random_r, named like the other generators
+static inline uint32_t pcg32_r(pcg32_random_t *rng) { return pcg32_random_r(rng); }
+
 static inline uint32_t pcg32(void) { return pcg32_random_r(&pcg32_global); }
 
+static inline void pcg32_advance(uint64_t delta) {
+  pcg32_advance_r(&pcg32_global, delta);
+}
+
+FILL_GENERIC(pcg32, pcg32_random_t, uint32_t, pcg32_global)
+
 #endif // PCG32_H
@@ -4,6 +4,7 @@
 /* Modified by D. Lemire based on original code by M. O'Neill, August 2017 */
 #include "splitmix64.h" // we are going to leverage splitmix64 to generate the seed
 #include <stdint.h>
+#include "fill.h"
 
 /***
 * start of the code copied verbatim from O'Neill's, except that we declare some
@@ -28,6 +29,29 @@ static inline void pcg_setseq_128_step_r(struct pcg_state_setseq_128 *rng) {
   rng->state = rng->state * PCG_DEFAULT_MULTIPLIER_128 + rng->inc;
 }
 
+static inline pcg128_t pcg_advance_lcg_128(pcg128_t state, pcg128_t delta,
+                                           pcg128_t cur_mult,
+                                           pcg128_t cur_plus) {
+  pcg128_t acc_mult = 1u;
+  pcg128_t acc_plus = 0u;
+  while (delta > 0) {
+    if (delta & 1) {
+      acc_mult *= cur_mult;
+      acc_plus = acc_plus * cur_mult + cur_plus;
+    }
+    cur_plus = (cur_mult + 1) * cur_plus;
+    cur_mult *= cur_mult;
+    delta /= 2;
+  }
+  return acc_mult * state + acc_plus;
+}
+
+static inline void pcg_setseq_128_advance_r(struct pcg_state_setseq_128 *rng,
+                                            pcg128_t delta) {
+  rng->state = pcg_advance_lcg_128(rng->state, delta,
+                                   PCG_DEFAULT_MULTIPLIER_128, rng->inc);
+}
+
 static inline void pcg_setseq_128_srandom_r(struct pcg_state_setseq_128 *rng,
                                             pcg128_t initstate,
                                             pcg128_t initseq) {
@@ -62,7 +86,7 @@ pcg_setseq_128_xsl_rr_64_random_r(struct pcg_state_setseq_128 *rng) {
 static pcg64_random_t pcg64_global; // global state
 
 // call this once before calling pcg64_random_r
-static inline void pcg64_seed(uint64_t seed) {
+static inline void pcg64_seed_r(pcg64_random_t *rng, uint64_t seed) {
   pcg128_t initstate = PCG_128BIT_CONSTANT(splitmix64_stateless(seed, 0),
                                            splitmix64_stateless(seed, 1));
   // we pick a sequence at random
@@ -70,11 +94,43 @@ static inline void pcg64_seed(uint64_t seed) {
                                          splitmix64_stateless(seed, 3));
   initseq |= 1; // should not be necessary, but let us be careful.
 
-  pcg_setseq_128_srandom_r(&pcg64_global, initstate, initseq);
+  pcg_setseq_128_srandom_r(rng, initstate, initseq);
+}
+
+// Seeds the generator on the stream (increment) selected by stream_id.
+// Generators seeded alike on distinct streams produce distinct sequences.
+static inline void pcg64_seed_stream_r(pcg64_random_t *rng, uint64_t seed,
+                                       uint64_t stream_id) {
+  pcg128_t initstate = PCG_128BIT_CONSTANT(splitmix64_stateless(seed, 0),
+                                           splitmix64_stateless(seed, 1));
+  pcg_setseq_128_srandom_r(rng, initstate, stream_id);
+}
+
+// seeds the global state
+static inline void pcg64_seed(uint64_t seed) { pcg64_seed_r(&pcg64_global, seed); }
+
+// Jumps ahead by delta steps in O(log delta) time. The period is 2^128 so
+// that advancing by -delta goes back.
+static inline void pcg64_advance_r(pcg64_random_t *rng, pcg128_t delta) {
+  pcg_setseq_128_advance_r(rng, delta);
+}
+
+// skips the next n outputs, as n calls to pcg64_random_r would
+static inline void pcg64_discard_r(pcg64_random_t *rng, pcg128_t n) {
+  pcg_setseq_128_advance_r(rng, n);
 }
 
 #define pcg64_random_r pcg_setseq_128_xsl_rr_64_random_r
 
+// same as pcg64_random_r, named like the other generators
+static inline uint64_t pcg64_r(pcg64_random_t *rng) { return pcg64_random_r(rng); }
+
 static inline uint64_t pcg64(void) { return pcg64_random_r(&pcg64_global); }
 
+static inline void pcg64_advance(pcg128_t delta) {
+  pcg64_advance_r(&pcg64_global, delta);
+}
+
+FILL_GENERIC(pcg64, pcg64_random_t, uint64_t, pcg64_global)
+
 #endif
@@ -0,0 +1,387 @@
+#ifndef PHILOX_H
+#define PHILOX_H
+
+// Philox4x32-10 and Philox4x64-10, the counter-based generators of
+// Salmon, Moraes, Dror and Shaw, "Parallel random numbers: as easy as
+// 1, 2, 3" (SC 2011). Block i of the stream is the encryption of the
+// counter i under the key, so any output can be computed directly from
+// (key, position) and several blocks can be computed at once. The block
+// functions produce the same outputs as the Random123 library.
+//
+// The stream of 64-bit words is the concatenation of the blocks: with
+// philox4x32, word i is made of the 32-bit outputs 2 (i % 2) and
+// 2 (i % 2) + 1 of block i / 2, the first one in the least significant
+// bits; with philox4x64, word i is output i % 4 of block i / 4.
+//
+// NAME_seek_r(state, i) moves the generator to word i in constant time, so
+// that every thread can produce its own slice of a single stream.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "avx512warnings.h"
+#include "simd64.h"
+#include "splitmix64.h"
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#define PHILOX_M4x32_0 UINT32_C(0xD2511F53)
+#define PHILOX_M4x32_1 UINT32_C(0xCD9E8D57)
+#define PHILOX_W32_0 UINT32_C(0x9E3779B9)
+#define PHILOX_W32_1 UINT32_C(0xBB67AE85)
+#define PHILOX_M4x64_0 UINT64_C(0xD2E7470EE14C6C93)
+#define PHILOX_M4x64_1 UINT64_C(0xCA5A826395121157)
+#define PHILOX_W64_0 UINT64_C(0x9E3779B97F4A7C15)
+#define PHILOX_W64_1 UINT64_C(0xBB67AE8584CAA73B)
+#define PHILOX_ROUNDS 10
+
+// encrypts the counter ctr under key, 10 rounds
+static inline void philox4x32_block(const uint32_t ctr[4], const uint32_t key[2],
+                                    uint32_t out[4]) {
+  uint32_t x0 = ctr[0], x1 = ctr[1], x2 = ctr[2], x3 = ctr[3];
+  uint32_t k0 = key[0], k1 = key[1];
+  for (int r = 0; r < PHILOX_ROUNDS; r++) {
+    if (r > 0) {
+      k0 += PHILOX_W32_0;
+      k1 += PHILOX_W32_1;
+    }
+    const uint64_t p0 = (uint64_t)PHILOX_M4x32_0 * x0;
+    const uint64_t p1 = (uint64_t)PHILOX_M4x32_1 * x2;
+    x0 = (uint32_t)(p1 >> 32) ^ x1 ^ k0;
+    x1 = (uint32_t)p1;
+    x2 = (uint32_t)(p0 >> 32) ^ x3 ^ k1;
+    x3 = (uint32_t)p0;
+  }
+  out[0] = x0;
+  out[1] = x1;
+  out[2] = x2;
+  out[3] = x3;
+}
+
+static inline void philox4x64_block(const uint64_t ctr[4], const uint64_t key[2],
+                                    uint64_t out[4]) {
+  uint64_t x0 = ctr[0], x1 = ctr[1], x2 = ctr[2], x3 = ctr[3];
+  uint64_t k0 = key[0], k1 = key[1];
+  for (int r = 0; r < PHILOX_ROUNDS; r++) {
+    if (r > 0) {
+      k0 += PHILOX_W64_0;
+      k1 += PHILOX_W64_1;
+    }
+    const __uint128_t p0 = (__uint128_t)PHILOX_M4x64_0 * x0;
+    const __uint128_t p1 = (__uint128_t)PHILOX_M4x64_1 * x2;
+    x0 = (uint64_t)(p1 >> 64) ^ x1 ^ k0;
+    x1 = (uint64_t)p1;
+    x2 = (uint64_t)(p0 >> 64) ^ x3 ^ k1;
+    x3 = (uint64_t)p0;
+  }
+  out[0] = x0;
+  out[1] = x1;
+  out[2] = x2;
+  out[3] = x3;
+}
+
+////
+// philox4x32: the counter of block b is {b, b >> 32, 0, 0}
+////
+
+typedef struct {
+  uint32_t key[2];
+  uint64_t counter; // next block
+  uint64_t buffer[2];
+  size_t offset;
+} philox4x32_state;
+
+static philox4x32_state g_philox4x32_state;
+
+static inline void philox4x32_block_at(const philox4x32_state *state,
+                                       uint64_t block, uint64_t out[2]) {
+  const uint32_t ctr[4] = {(uint32_t)block, (uint32_t)(block >> 32), 0, 0};
+  uint32_t x[4];
+  philox4x32_block(ctr, state->key, x);
+  out[0] = x[0] | ((uint64_t)x[1] << 32);
+  out[1] = x[2] | ((uint64_t)x[3] << 32);
+}
+
+static inline void philox4x32_seed_r(philox4x32_state *state, uint64_t seed) {
+  const uint64_t key = splitmix64_r(&seed);
+  state->key[0] = (uint32_t)key;
+  state->key[1] = (uint32_t)(key >> 32);
+  state->counter = 0;
+  state->offset = 2;
+}
+
+// moves to word index of the stream
+static inline void philox4x32_seek_r(philox4x32_state *state, uint64_t index) {
+  philox4x32_block_at(state, index / 2, state->buffer);
+  state->counter = index / 2 + 1;
+  state->offset = index % 2;
+}
+
+// word index of the stream, without changing the state
+static inline uint64_t philox4x32_at_r(const philox4x32_state *state,
+                                       uint64_t index) {
+  uint64_t block[2];
+  philox4x32_block_at(state, index / 2, block);
+  return block[index % 2];
+}
+
+static inline uint64_t philox4x32_r(philox4x32_state *state) {
+  if (__builtin_expect(state->offset >= 2, 0)) {
+    philox4x32_block_at(state, state->counter++, state->buffer);
+    state->offset = 0;
+  }
+  return state->buffer[state->offset++];
+}
+
+#if defined(__AVX2__)
+// Several blocks at once, one per 32-bit lane: PHILOX4X32_BLOCKS blocks are
+// written to out, in order, from block b (whose low 32 bits must not wrap
+// within the batch).
+#if defined(__AVX512F__)
+#define PHILOX4X32_BLOCKS 16
+typedef __m512i philox4x32_vec;
+#define philox4x32_vset1(x) _mm512_set1_epi32((int)(x))
+#define philox4x32_vxor(a, b) _mm512_xor_si512(a, b)
+#define philox4x32_vadd(a, b) _mm512_add_epi32(a, b)
+#define philox4x32_vmul_epu32(a, b) avx512_mul_epu32(a, b)
+#define philox4x32_vsrli64(a, k) avx512_srli_epi64(a, k)
+#define philox4x32_vslli64(a, k) avx512_slli_epi64(a, k)
+#define philox4x32_vblend_odd(even, odd) _mm512_mask_blend_epi32(0xAAAA, even, odd)
+#define philox4x32_iota()                                                      \
+  _mm512_set_epi32(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#else
+#define PHILOX4X32_BLOCKS 8
+typedef __m256i philox4x32_vec;
+#define philox4x32_vset1(x) _mm256_set1_epi32((int)(x))
+#define philox4x32_vxor(a, b) _mm256_xor_si256(a, b)
+#define philox4x32_vadd(a, b) _mm256_add_epi32(a, b)
+#define philox4x32_vmul_epu32(a, b) _mm256_mul_epu32(a, b)
+#define philox4x32_vsrli64(a, k) _mm256_srli_epi64(a, k)
+#define philox4x32_vslli64(a, k) _mm256_slli_epi64(a, k)
+#define philox4x32_vblend_odd(even, odd) _mm256_blend_epi32(even, odd, 0xAA)
+#define philox4x32_iota() _mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0)
+#endif
+
+// 32-bit by 32-bit products of every lane: returns the low halves and
+// stores the high halves in *hi
+static inline philox4x32_vec philox4x32_vmulhilo(philox4x32_vec a, uint32_t m,
+                                                 philox4x32_vec *hi) {
+  const philox4x32_vec mv = philox4x32_vset1(m);
+  const philox4x32_vec even = philox4x32_vmul_epu32(a, mv);
+  const philox4x32_vec odd =
+      philox4x32_vmul_epu32(philox4x32_vsrli64(a, 32), mv);
+  *hi = philox4x32_vblend_odd(philox4x32_vsrli64(even, 32), odd);
+  return philox4x32_vblend_odd(even, philox4x32_vslli64(odd, 32));
+}
+
+static inline void philox4x32_blocks(const uint32_t key[2], uint64_t b,
+                                     uint64_t *out) {
+  philox4x32_vec x0 = philox4x32_vadd(philox4x32_vset1((uint32_t)b),
+                                      philox4x32_iota());
+  philox4x32_vec x1 = philox4x32_vset1((uint32_t)(b >> 32));
+  philox4x32_vec x2 = philox4x32_vset1(0);
+  philox4x32_vec x3 = philox4x32_vset1(0);
+  uint32_t k0 = key[0], k1 = key[1];
+  for (int r = 0; r < PHILOX_ROUNDS; r++) {
+    if (r > 0) {
+      k0 += PHILOX_W32_0;
+      k1 += PHILOX_W32_1;
+    }
+    philox4x32_vec hi0, hi1;
+    const philox4x32_vec lo0 = philox4x32_vmulhilo(x0, PHILOX_M4x32_0, &hi0);
+    const philox4x32_vec lo1 = philox4x32_vmulhilo(x2, PHILOX_M4x32_1, &hi1);
+    x0 = philox4x32_vxor(philox4x32_vxor(hi1, x1), philox4x32_vset1(k0));
+    x1 = lo1;
+    x2 = philox4x32_vxor(philox4x32_vxor(hi0, x3), philox4x32_vset1(k1));
+    x3 = lo0;
+  }
+  // from one vector per output word to one block after the other: first a
+  // 4x4 transpose within each 128-bit lane, then of the 128-bit lanes
+#if defined(__AVX512F__)
+  const __m512i a0 = avx512_unpacklo_epi32(x0, x1);
+  const __m512i a1 = avx512_unpackhi_epi32(x0, x1);
+  const __m512i a2 = avx512_unpacklo_epi32(x2, x3);
+  const __m512i a3 = avx512_unpackhi_epi32(x2, x3);
+  const __m512i r0 = avx512_unpacklo_epi64(a0, a2); // blocks 0, 4, 8, 12
+  const __m512i r1 = avx512_unpackhi_epi64(a0, a2); // blocks 1, 5, 9, 13
+  const __m512i r2 = avx512_unpacklo_epi64(a1, a3); // blocks 2, 6, 10, 14
+  const __m512i r3 = avx512_unpackhi_epi64(a1, a3); // blocks 3, 7, 11, 15
+  const __m512i t0 = avx512_shuffle_i32x4(r0, r1, 0x44); // 0, 4, 1, 5
+  const __m512i t1 = avx512_shuffle_i32x4(r2, r3, 0x44); // 2, 6, 3, 7
+  const __m512i t2 = avx512_shuffle_i32x4(r0, r1, 0xEE); // 8, 12, 9, 13
+  const __m512i t3 = avx512_shuffle_i32x4(r2, r3, 0xEE); // 10, 14, 11, 15
+  _mm512_storeu_si512((void *)out, avx512_shuffle_i32x4(t0, t1, 0x88));
+  _mm512_storeu_si512((void *)(out + 8), avx512_shuffle_i32x4(t0, t1, 0xDD));
+  _mm512_storeu_si512((void *)(out + 16), avx512_shuffle_i32x4(t2, t3, 0x88));
+  _mm512_storeu_si512((void *)(out + 24), avx512_shuffle_i32x4(t2, t3, 0xDD));
+#else
+  const __m256i a0 = _mm256_unpacklo_epi32(x0, x1);
+  const __m256i a1 = _mm256_unpackhi_epi32(x0, x1);
+  const __m256i a2 = _mm256_unpacklo_epi32(x2, x3);
+  const __m256i a3 = _mm256_unpackhi_epi32(x2, x3);
+  const __m256i r0 = _mm256_unpacklo_epi64(a0, a2); // blocks 0, 4
+  const __m256i r1 = _mm256_unpackhi_epi64(a0, a2); // blocks 1, 5
+  const __m256i r2 = _mm256_unpacklo_epi64(a1, a3); // blocks 2, 6
+  const __m256i r3 = _mm256_unpackhi_epi64(a1, a3); // blocks 3, 7
+  _mm256_storeu_si256((__m256i *)out, _mm256_permute2x128_si256(r0, r1, 0x20));
+  _mm256_storeu_si256((__m256i *)(out + 4), _mm256_permute2x128_si256(r2, r3, 0x20));
+  _mm256_storeu_si256((__m256i *)(out + 8), _mm256_permute2x128_si256(r0, r1, 0x31));
+  _mm256_storeu_si256((__m256i *)(out + 12), _mm256_permute2x128_si256(r2, r3, 0x31));
+#endif
+}
+#endif // __AVX2__
+
+// writes the next n words of the stream, the same ones that n calls to
+// philox4x32_r would have returned
+static inline void philox4x32_fill_r(philox4x32_state *state, uint64_t *out,
+                                     size_t n) {
+  size_t i = 0;
+  while (i < n && state->offset < 2) {
+    out[i++] = state->buffer[state->offset++];
+  }
+#if defined(__AVX2__)
+  while (i + 2 * PHILOX4X32_BLOCKS <= n) {
+    if ((uint32_t)state->counter <= UINT32_MAX - (PHILOX4X32_BLOCKS - 1)) {
+      philox4x32_blocks(state->key, state->counter, out + i);
+      state->counter += PHILOX4X32_BLOCKS;
+      i += 2 * PHILOX4X32_BLOCKS;
+    } else { // the low 32 bits of the counter wrap within the batch
+      philox4x32_block_at(state, state->counter++, out + i);
+      i += 2;
+    }
+  }
+#endif
+  for (; i + 2 <= n; i += 2) {
+    philox4x32_block_at(state, state->counter++, out + i);
+  }
+  for (; i < n; i++) {
+    out[i] = philox4x32_r(state);
+  }
+}
+
+static inline void philox4x32_seed(uint64_t seed) {
+  philox4x32_seed_r(&g_philox4x32_state, seed);
+}
+
+static inline uint64_t philox4x32(void) {
+  return philox4x32_r(&g_philox4x32_state);
+}
+
+static inline void philox4x32_fill(uint64_t *out, size_t n) {
+  philox4x32_fill_r(&g_philox4x32_state, out, n);
+}
+
+////
+// philox4x64: the counter of block b is {b, 0, 0, 0}
+////
+
+typedef struct {
+  uint64_t key[2];
+  uint64_t counter; // next block
+  uint64_t buffer[4];
+  size_t offset;
+} philox4x64_state;
+
+static philox4x64_state g_philox4x64_state;
+
+static inline void philox4x64_block_at(const philox4x64_state *state,
+                                       uint64_t block, uint64_t out[4]) {
+  const uint64_t ctr[4] = {block, 0, 0, 0};
+  philox4x64_block(ctr, state->key, out);
+}
+
+static inline void philox4x64_seed_r(philox4x64_state *state, uint64_t seed) {
+  state->key[0] = splitmix64_r(&seed);
+  state->key[1] = splitmix64_r(&seed);
+  state->counter = 0;
+  state->offset = 4;
+}
+
+// moves to word index of the stream
+static inline void philox4x64_seek_r(philox4x64_state *state, uint64_t index) {
+  philox4x64_block_at(state, index / 4, state->buffer);
+  state->counter = index / 4 + 1;
+  state->offset = index % 4;
+}
+
+// word index of the stream, without changing the state
+static inline uint64_t philox4x64_at_r(const philox4x64_state *state,
+                                       uint64_t index) {
+  uint64_t block[4];
+  philox4x64_block_at(state, index / 4, block);
+  return block[index % 4];
+}
+
+static inline uint64_t philox4x64_r(philox4x64_state *state) {
+  if (__builtin_expect(state->offset >= 4, 0)) {
+    philox4x64_block_at(state, state->counter++, state->buffer);
+    state->offset = 0;
+  }
+  return state->buffer[state->offset++];
+}
+
+#if defined(SIMD64_FAST_MULFULL)
+// SIMD64_LANES blocks at once, one per 64-bit lane, written to out in order
+// from block b
+static inline void philox4x64_blocks(const uint64_t key[2], uint64_t b,
+                                     uint64_t *out) {
+  simd64_t x0 = simd64_weyl(b - 1, 1);
+  simd64_t x1 = simd64_set1(0);
+  simd64_t x2 = simd64_set1(0);
+  simd64_t x3 = simd64_set1(0);
+  const simd64_t m0 = simd64_set1(PHILOX_M4x64_0);
+  const simd64_t m1 = simd64_set1(PHILOX_M4x64_1);
+  uint64_t k0 = key[0], k1 = key[1];
+  for (int r = 0; r < PHILOX_ROUNDS; r++) {
+    if (r > 0) {
+      k0 += PHILOX_W64_0;
+      k1 += PHILOX_W64_1;
+    }
+    simd64_t hi0, hi1;
+    const simd64_t lo0 = simd64_mulfull(x0, m0, &hi0);
+    const simd64_t lo1 = simd64_mulfull(x2, m1, &hi1);
+    x0 = simd64_xor(simd64_xor(hi1, x1), simd64_set1(k0));
+    x1 = lo1;
+    x2 = simd64_xor(simd64_xor(hi0, x3), simd64_set1(k1));
+    x3 = lo0;
+  }
+  simd64_store_blocks4(out, x0, x1, x2, x3);
+}
+#endif // SIMD64_FAST_MULFULL
+
+// writes the next n words of the stream, the same ones that n calls to
+// philox4x64_r would have returned
+static inline void philox4x64_fill_r(philox4x64_state *state, uint64_t *out,
+                                     size_t n) {
+  size_t i = 0;
+  while (i < n && state->offset < 4) {
+    out[i++] = state->buffer[state->offset++];
+  }
+#if defined(SIMD64_FAST_MULFULL)
+  for (; i + 4 * SIMD64_LANES <= n; i += 4 * SIMD64_LANES) {
+    philox4x64_blocks(state->key, state->counter, out + i);
+    state->counter += SIMD64_LANES;
+  }
+#endif
+  for (; i + 4 <= n; i += 4) {
+    philox4x64_block_at(state, state->counter++, out + i);
+  }
+  for (; i < n; i++) {
+    out[i] = philox4x64_r(state);
+  }
+}
+
+static inline void philox4x64_seed(uint64_t seed) {
+  philox4x64_seed_r(&g_philox4x64_state, seed);
+}
+
+static inline uint64_t philox4x64(void) {
+  return philox4x64_r(&g_philox4x64_state);
+}
+
+static inline void philox4x64_fill(uint64_t *out, size_t n) {
+  philox4x64_fill_r(&g_philox4x64_state, out, n);
+}
+
+#endif // PHILOX_H
@@ -0,0 +1,301 @@
+#ifndef REGISTRY_H
+#define REGISTRY_H
+
+// The one list of our generators. The speed benchmark, the PractRand and
+// TestU01 drivers, the entropy test and their scripts all take their
+// generators from rng_registry, so a new generator is added here once: an
+// RNG_ADAPT line, which wraps its reentrant functions for a void *state,
+// and an RNG_ENTRY line in rng_registry.
+//
+// Some streams have several implementations, e.g. aesctr_vaes computes the
+// aesctr stream with VAES: their entries share the name, and the fastest
+// comes first, so that rng_find picks it when the processor supports it.
+
+#include <string.h>
+
+#include "rnginfo.h"
+
+#include "CG128-64.h"
+#include "CG128.h"
+#include "CG64.h"
+#include "jenkinssmall.h"
+#include "lehmer64.h"
+#include "lehmer64x.h"
+#include "mersennetwister.h"
+#include "mitchellmoore.h"
+#include "pcg32.h"
+#include "pcg64.h"
+#include "philox.h"
+#include "splitmix63.h"
+#include "splitmix64.h"
+#include "threefry.h"
+#include "trivium32.h"
+#include "trivium64.h"
+#include "w1rand.h"
+#include "widynski.h"
+#include "wyhash.h"
+#include "wyrand.h"
+#include "wyrandx.h"
+#include "xoroshiro128plus.h"
+#include "xorshift-k4.h"
+#include "xorshift-k5.h"
+#include "xorshift1024plus.h"
+#include "xorshift1024star.h"
+#include "xorshift128plus.h"
+#include "xorshift32.h"
+#ifdef __AES__
+#include "aesctr.h"
+#include "aesdragontamer.h"
+#endif
+#ifdef __AVX2__
+#include "simdtrivium64.h"
+#include "simdxoroshiro128plus.h"
+#include "simdxorshift128plus.h"
+#endif
+
+// impl_registry_seed, _next and _fill call seed_fn, next_fn and fill_fn on
+// the state of the generator; impl_registry_populate is the loop of n calls
+// to next_fn, where the compiler can inline it
+#define RNG_ADAPTERS(impl, state_type, word_type, seed_fn, next_fn, fill_fn)  \
+  static inline void impl##_registry_seed(void *state, uint64_t seed) {       \
+    seed_fn((state_type *)state, seed);                                       \
+  }                                                                           \
+  static inline word_type impl##_registry_next(void *state) {                 \
+    return next_fn((state_type *)state);                                      \
+  }                                                                           \
+  static inline void impl##_registry_fill(void *state, void *out, size_t n) { \
+    fill_fn((state_type *)state, (word_type *)out, n);                        \
+  }                                                                           \
+  static inline void impl##_registry_populate(void *state, void *out,         \
+                                              size_t n) {                     \
+    for (size_t i = 0; i < n; i++)                                            \
+      ((word_type *)out)[i] = next_fn((state_type *)state);                   \
+  }
+
+// the usual case: impl_seed_r, impl_r and impl_fill_r
+#define RNG_ADAPT(impl, state_type, word_type)                                \
+  RNG_ADAPTERS(impl, state_type, word_type, impl##_seed_r, impl##_r,         \
+               impl##_fill_r)
+
+#define RNG_ADAPT_JUMP(impl, state_type)                                      \
+  static inline void impl##_registry_jump(void *state) {                      \
+    impl##_jump_r((state_type *)state);                                       \
+  }
+
+#define RNG_ENTRY(name, impl, bits, state_type, isa)                          \
+  {#name, #impl, bits, sizeof(state_type), impl##_registry_seed,              \
+   {.next##bits = impl##_registry_next}, impl##_registry_fill,                \
+   impl##_registry_populate, isa, NULL, 0}
+
+#define RNG_ENTRY_JUMP(name, impl, bits, state_type, isa, jump_log2)          \
+  {#name, #impl, bits, sizeof(state_type), impl##_registry_seed,              \
+   {.next##bits = impl##_registry_next}, impl##_registry_fill,                \
+   impl##_registry_populate, isa, impl##_registry_jump, jump_log2}
+
+// the generators that take more than a seed get it here
+static inline void trivium32_seq0_seed_r(trivium32_state *state,
+                                         uint64_t seed) {
+  trivium32_seed_r(state, seed, 0);
+}
+
+static inline void trivium64_seq0_seed_r(trivium64_state *state,
+                                         uint64_t seed) {
+  trivium64_seed_r(state, seed, 0);
+}
+
+#define RNG_LANES(name, lanes)                                                \
+  static inline void name##lanes##_seed_r(name##_state *state,                \
+                                          uint64_t seed) {                    \
+    name##_seed_r(state, seed, lanes);                                        \
+  }                                                                           \
+  RNG_ADAPTERS(name##lanes, name##_state, uint64_t, name##lanes##_seed_r,    \
+               name##_r, name##_fill_r)
+
+RNG_ADAPTERS(trivium32, trivium32_state, uint32_t, trivium32_seq0_seed_r,
+             trivium32_r, trivium32_fill_r)
+RNG_ADAPT(xorshift_k4, xorshift_k4_state, uint32_t)
+RNG_ADAPT(xorshift_k5, xorshift_k5_state, uint32_t)
+RNG_ADAPT(mersennetwister, mersennetwister_state, uint32_t)
+RNG_ADAPT(mitchellmoore, mitchellmoore_state, uint32_t)
+RNG_ADAPT(widynski, widynski_state, uint32_t)
+RNG_ADAPT(xorshift32, unsigned int, uint32_t)
+RNG_ADAPT(pcg32, pcg32_random_t, uint32_t)
+
+RNG_ADAPTERS(trivium64, trivium64_state, uint64_t, trivium64_seq0_seed_r,
+             trivium64_r, trivium64_fill_r)
+RNG_ADAPT(lehmer64, __uint128_t, uint64_t)
+RNG_LANES(lehmer64x, 2)
+RNG_LANES(lehmer64x, 4)
+RNG_LANES(lehmer64x, 8)
+RNG_ADAPT(xorshift128plus, xorshift128plus_key_t, uint64_t)
+RNG_ADAPT_JUMP(xorshift128plus, xorshift128plus_key_t)
+RNG_ADAPT(v8xorshift128plus, xorshift128plus_key_t, uint64_t)
+RNG_ADAPT(xoroshiro128plus, xoroshiro128plus_state, uint64_t)
+RNG_ADAPT_JUMP(xoroshiro128plus, xoroshiro128plus_state)
+RNG_ADAPT(splitmix64, uint64_t, uint64_t)
+RNG_ADAPT(splitmix63, uint64_t, uint64_t)
+RNG_ADAPT(pcg64, pcg64_random_t, uint64_t)
+RNG_ADAPT(xorshift1024star, xorshift1024star_state, uint64_t)
+RNG_ADAPT_JUMP(xorshift1024star, xorshift1024star_state)
+RNG_ADAPT(xorshift1024plus, xorshift1024plus_state, uint64_t)
+RNG_ADAPT(wyhash64, uint64_t, uint64_t)
+RNG_ADAPT(wyrand, uint64_t, uint64_t)
+RNG_LANES(wyrandx, 2)
+RNG_LANES(wyrandx, 4)
+RNG_LANES(wyrandx, 8)
+RNG_ADAPT(w1rand, uint64_t, uint64_t)
+RNG_ADAPT(jenkinssmall, jenkinssmall_ranctx, uint64_t)
+RNG_ADAPT(philox4x32, philox4x32_state, uint64_t)
+RNG_ADAPT(philox4x64, philox4x64_state, uint64_t)
+RNG_ADAPT(threefry2x64, threefry2x64_state, uint64_t)
+RNG_ADAPT(threefry4x64, threefry4x64_state, uint64_t)
+RNG_ADAPT(CG64, CG64_state, uint64_t)
+
+RNG_ADAPT(CG128, CG128_state, __uint128_t)
+RNG_ADAPT(CG128_64, CG128_64_state, __uint128_t)
+
+#ifdef __AES__
+// aesctr encrypting `unroll` blocks together; aesctr itself uses AESCTR_UNROLL
+#define RNG_AESCTR_UNROLL(unroll)                                             \
+  static inline uint64_t aesctr_unroll##unroll##_r(aesctr_state *state) {     \
+    return aesctr_unrolled_r(state, unroll);                                  \
+  }                                                                           \
+  static inline void aesctr_unroll##unroll##_fill_r(aesctr_state *state,      \
+                                                    uint64_t *out, size_t n) {\
+    aesctr_fill_unrolled_r(state, out, n * sizeof(uint64_t), unroll);         \
+  }                                                                           \
+  RNG_ADAPTERS(aesctr_unroll##unroll, aesctr_state, uint64_t, aesctr_seed_r, \
+               aesctr_unroll##unroll##_r, aesctr_unroll##unroll##_fill_r)
+
+RNG_ADAPT(aesdragontamer, aesdragontamer_state, uint64_t)
+RNG_ADAPT(aesctr, aesctr_state, uint64_t)
+RNG_AESCTR_UNROLL(8)
+RNG_AESCTR_UNROLL(16)
+#ifdef AESCTR_VAES_LANES
+RNG_ADAPTERS(aesctr_vaes, aesctr_state, uint64_t, aesctr_seed_r,
+             aesctr_vaes_r, aesctr_vaes_fill_r)
+#endif
+#ifdef AESDRAGONTAMER_VAES_LANES
+RNG_ADAPTERS(aesdragontamer_vaes, aesdragontamer_state, uint64_t,
+             aesdragontamer_seed_r, aesdragontamer_vaes_r,
+             aesdragontamer_vaes_fill_r)
+#endif
+#endif
+
+#ifdef __AVX2__
+static inline void simdtrivium64_seq0_seed_r(simdtrivium64_state *state,
+                                             uint64_t seed) {
+  simdtrivium64_seed_r(state, seed, 0);
+}
+
+RNG_ADAPT(simdxorshift128plus, simdxorshift128plus_state, uint64_t)
+RNG_ADAPT(simdxoroshiro128plus, simdxoroshiro128plus_state, uint64_t)
+RNG_ADAPTERS(simdtrivium64, simdtrivium64_state, uint64_t,
+             simdtrivium64_seq0_seed_r, simdtrivium64_r, simdtrivium64_fill_r)
+#endif
+
+// The generators with a vector kernel (their own, simd64.h or the Mersenne
+// Twister's MT_LANES) use 256-bit vectors when built with AVX2 and 512-bit
+// ones when built with AVX-512: they need whichever of the two the build has.
+#define RNG_ISA_SIMD (RNG_ISA_BUILD_AVX2 | RNG_ISA_BUILD_AVX512)
+
+// The VAES kernels work on 512-bit vectors (4 blocks) when built with
+// AVX-512, and on 256-bit vectors (2 blocks) otherwise.
+#define RNG_ISA_VAES_SIMD(lanes)                                               \
+  (RNG_ISA_AES | RNG_ISA_AVX2 | RNG_ISA_VAES |                                 \
+   ((lanes) == 4 ? RNG_ISA_AVX512 : 0u))
+
+static const rng_info rng_registry[] = {
+    // 32-bit generators
+    RNG_ENTRY(trivium32, trivium32, 32, trivium32_state, 0),
+    RNG_ENTRY(xorshift_k4, xorshift_k4, 32, xorshift_k4_state, 0),
+    RNG_ENTRY(xorshift_k5, xorshift_k5, 32, xorshift_k5_state, 0),
+    RNG_ENTRY(mersennetwister, mersennetwister, 32, mersennetwister_state,
+              RNG_ISA_SIMD),
+    RNG_ENTRY(mitchellmoore, mitchellmoore, 32, mitchellmoore_state, 0),
+    RNG_ENTRY(widynski, widynski, 32, widynski_state, 0),
+    RNG_ENTRY(xorshift32, xorshift32, 32, unsigned int, 0),
+    RNG_ENTRY(pcg32, pcg32, 32, pcg32_random_t, 0),
+
+    // 64-bit generators
+    RNG_ENTRY(trivium64, trivium64, 64, trivium64_state, 0),
+#ifdef __AES__
+#ifdef AESDRAGONTAMER_VAES_LANES
+    RNG_ENTRY(aesdragontamer, aesdragontamer_vaes, 64, aesdragontamer_state,
+              RNG_ISA_VAES_SIMD(AESDRAGONTAMER_VAES_LANES)),
+#endif
+    RNG_ENTRY(aesdragontamer, aesdragontamer, 64, aesdragontamer_state,
+              RNG_ISA_AES),
+#ifdef AESCTR_VAES_LANES
+    RNG_ENTRY(aesctr, aesctr_vaes, 64, aesctr_state,
+              RNG_ISA_VAES_SIMD(AESCTR_VAES_LANES)),
+#endif
+    // 8 blocks at a time beat 4 (aesctr.h), and 16 do no better
+    RNG_ENTRY(aesctr, aesctr_unroll8, 64, aesctr_state, RNG_ISA_AES),
+    RNG_ENTRY(aesctr, aesctr, 64, aesctr_state, RNG_ISA_AES),
+    RNG_ENTRY(aesctr, aesctr_unroll16, 64, aesctr_state, RNG_ISA_AES),
+#endif
+    RNG_ENTRY(lehmer64, lehmer64, 64, __uint128_t, 0),
+    RNG_ENTRY(lehmer64x2, lehmer64x2, 64, lehmer64x_state, 0),
+    RNG_ENTRY(lehmer64x4, lehmer64x4, 64, lehmer64x_state, 0),
+    RNG_ENTRY(lehmer64x8, lehmer64x8, 64, lehmer64x_state, 0),
+    RNG_ENTRY_JUMP(xorshift128plus, xorshift128plus, 64, xorshift128plus_key_t,
+                   0, 64),
+    RNG_ENTRY(v8xorshift128plus, v8xorshift128plus, 64, xorshift128plus_key_t,
+              0),
+    RNG_ENTRY_JUMP(xoroshiro128plus, xoroshiro128plus, 64,
+                   xoroshiro128plus_state, 0, 64),
+#ifdef __AVX2__
+    RNG_ENTRY(simdxorshift128plus, simdxorshift128plus, 64,
+              simdxorshift128plus_state, RNG_ISA_SIMD),
+    RNG_ENTRY(simdxoroshiro128plus, simdxoroshiro128plus, 64,
+              simdxoroshiro128plus_state, RNG_ISA_SIMD),
+    RNG_ENTRY(simdtrivium64, simdtrivium64, 64, simdtrivium64_state,
+              RNG_ISA_SIMD),
+#endif
+    RNG_ENTRY(splitmix64, splitmix64, 64, uint64_t, RNG_ISA_SIMD),
+    RNG_ENTRY(splitmix63, splitmix63, 64, uint64_t, 0),
+    RNG_ENTRY(pcg64, pcg64, 64, pcg64_random_t, 0),
+    RNG_ENTRY_JUMP(xorshift1024star, xorshift1024star, 64,
+                   xorshift1024star_state, 0, 512),
+    RNG_ENTRY(xorshift1024plus, xorshift1024plus, 64, xorshift1024plus_state,
+              0),
+    RNG_ENTRY(wyhash64, wyhash64, 64, uint64_t, RNG_ISA_SIMD),
+    RNG_ENTRY(wyrand, wyrand, 64, uint64_t, RNG_ISA_SIMD),
+    RNG_ENTRY(wyrandx2, wyrandx2, 64, wyrandx_state, 0),
+    RNG_ENTRY(wyrandx4, wyrandx4, 64, wyrandx_state, 0),
+    RNG_ENTRY(wyrandx8, wyrandx8, 64, wyrandx_state, 0),
+    RNG_ENTRY(w1rand, w1rand, 64, uint64_t, RNG_ISA_SIMD),
+    RNG_ENTRY(jenkinssmall, jenkinssmall, 64, jenkinssmall_ranctx, 0),
+    RNG_ENTRY(philox4x32, philox4x32, 64, philox4x32_state, RNG_ISA_SIMD),
+    RNG_ENTRY(philox4x64, philox4x64, 64, philox4x64_state, RNG_ISA_SIMD),
+    RNG_ENTRY(threefry2x64, threefry2x64, 64, threefry2x64_state,
+              RNG_ISA_SIMD),
+    RNG_ENTRY(threefry4x64, threefry4x64, 64, threefry4x64_state,
+              RNG_ISA_SIMD),
+    RNG_ENTRY(CG64, CG64, 64, CG64_state, 0),
+
+    // 128-bit generators
+    RNG_ENTRY(CG128, CG128, 128, CG128_state, 0),
+    RNG_ENTRY(CG128_64, CG128_64, 128, CG128_64_state, 0),
+};
+
+#define RNG_REGISTRY_SIZE (sizeof(rng_registry) / sizeof(rng_registry[0]))
+
+// The generator called name: the fastest implementation of the stream
+// that the processor supports, or else the implementation of that name.
+// Returns NULL when there is none.
+static inline const rng_info *rng_find(const char *name) {
+  for (size_t i = 0; i < RNG_REGISTRY_SIZE; i++) {
+    if (strcmp(rng_registry[i].name, name) == 0 &&
+        rng_isa_supported(rng_registry[i].isa)) {
+      return &rng_registry[i];
+    }
+  }
+  for (size_t i = 0; i < RNG_REGISTRY_SIZE; i++) {
+    if (strcmp(rng_registry[i].impl, name) == 0) return &rng_registry[i];
+  }
+  return NULL;
+}
+
+#endif // REGISTRY_H
@@ -0,0 +1,110 @@
+#ifndef RNGINFO_H
+#define RNGINFO_H
+
+// What the harnesses need to know about a generator, whatever its state:
+// the entries of the registry (registry.h) have this type.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+// instruction sets that a generator, or a whole binary, requires
+#define RNG_ISA_AES 1u
+#define RNG_ISA_AVX2 2u
+#define RNG_ISA_AVX512 4u
+#define RNG_ISA_VAES 8u
+
+// the instruction sets this translation unit is compiled for: the
+// generators compiled in may use any of them
+#if defined(__AES__)
+#define RNG_ISA_BUILD_AES RNG_ISA_AES
+#else
+#define RNG_ISA_BUILD_AES 0u
+#endif
+#if defined(__AVX2__)
+#define RNG_ISA_BUILD_AVX2 RNG_ISA_AVX2
+#else
+#define RNG_ISA_BUILD_AVX2 0u
+#endif
+#if defined(__AVX512F__)
+#define RNG_ISA_BUILD_AVX512 RNG_ISA_AVX512
+#else
+#define RNG_ISA_BUILD_AVX512 0u
+#endif
+#if defined(__VAES__)
+#define RNG_ISA_BUILD_VAES RNG_ISA_VAES
+#else
+#define RNG_ISA_BUILD_VAES 0u
+#endif
+#define RNG_ISA_BUILD                                                         \
+  (RNG_ISA_BUILD_AES | RNG_ISA_BUILD_AVX2 | RNG_ISA_BUILD_AVX512 |            \
+   RNG_ISA_BUILD_VAES)
+
+// whether the processor we run on has every instruction set of isa
+static inline int rng_isa_supported(unsigned isa) {
+#if defined(__x86_64__) || defined(__i386__)
+  if ((isa & RNG_ISA_AES) && !__builtin_cpu_supports("aes")) return 0;
+  if ((isa & RNG_ISA_AVX2) && !__builtin_cpu_supports("avx2")) return 0;
+  if ((isa & RNG_ISA_AVX512) && !(__builtin_cpu_supports("avx512f") &&
+                                  __builtin_cpu_supports("avx512bw") &&
+                                  __builtin_cpu_supports("avx512dq") &&
+                                  __builtin_cpu_supports("avx512vl"))) {
+    return 0;
+  }
+  if ((isa & RNG_ISA_VAES) && !__builtin_cpu_supports("vaes")) return 0;
+  return 1;
+#else
+  return isa == 0;
+#endif
+}
+
+// one value, returned by the member that matches the width of the generator
+typedef union {
+  uint32_t (*next32)(void *state);
+  uint64_t (*next64)(void *state);
+  __uint128_t (*next128)(void *state);
+} rng_next_fnc;
+
+typedef struct {
+  // the stream: entries with the same name produce the same values
+  const char *name;
+  // this implementation of the stream, e.g. "aesctr_vaes" for "aesctr"
+  const char *impl;
+  // width of a value: 32, 64 or 128 bits
+  unsigned bits;
+  // the state has state_size bytes and must be aligned on 64 bytes
+  size_t state_size;
+  void (*seed)(void *state, uint64_t seed);
+  rng_next_fnc next;
+  // writes the next n values to out, as n calls to next would
+  void (*fill)(void *state, void *out, size_t n);
+  // the same values as fill, from a plain loop of calls to the generator
+  // compiled with it (for the speed benchmark: fill may use another
+  // algorithm, e.g. SIMD lanes)
+  void (*populate)(void *state, void *out, size_t n);
+  // the instruction sets the functions of the generator use (RNG_ISA_*),
+  // including the vector ones its fill was built for
+  unsigned isa;
+  // jumps 2^jump_log2 values ahead, when the generator can (or NULL)
+  void (*jump)(void *state);
+  unsigned jump_log2;
+} rng_info;
+
+// a state for the generator, to be seeded, then released with
+// rng_free_state (aligned_alloc is not in C99: we align by hand, and keep
+// the address returned by malloc just before the state)
+static inline void *rng_alloc_state(const rng_info *info) {
+  unsigned char *raw =
+      (unsigned char *)malloc(sizeof(void *) + 63 + info->state_size);
+  if (raw == NULL) return NULL;
+  uintptr_t address =
+      (uintptr_t)(raw + sizeof(void *) + 63) & ~(uintptr_t)63;
+  ((void **)address)[-1] = raw;
+  return (void *)address;
+}
+
+static inline void rng_free_state(void *state) {
+  if (state != NULL) free(((void **)state)[-1]);
+}
+
+#endif // RNGINFO_H
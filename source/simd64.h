@@ -0,0 +1,170 @@
+#ifndef SIMD64_H
+#define SIMD64_H
+#if defined(__AVX2__)
+
+// Small helpers over vectors of 64-bit words, so that the bulk fill
+// functions of the counter-based generators (splitmix64, wyrand, wyhash64,
+// w1rand, philox4x64, threefry) can be written once. With AVX-512 a vector
+// holds 8 words, otherwise (AVX2) it holds 4.
+//
+// x86 has no 64-bit by 64-bit multiplication with a 128-bit result in SIMD
+// registers. We build it from 52-bit multiply-adds (vpmadd52luq/vpmadd52huq)
+// when AVX-512IFMA is available, otherwise from 32-bit by 32-bit
+// multiplications (vpmuludq). AVX-512DQ gives us the low 64 bits directly
+// (vpmullq).
+//
+// The emulated 128-bit product costs more than a scalar mulx: with 4 lanes
+// (AVX2) it does not beat the scalar loop, with 8 lanes it does. Hence
+// SIMD64_FAST_MULFULL, which the generators relying on the full product
+// check before using it.
+
+#include <immintrin.h>
+#include <stdint.h>
+
+#include "avx512warnings.h"
+
+#if defined(__AVX512F__)
+#define SIMD64_LANES 8
+#define SIMD64_FAST_MULFULL 1
+typedef __m512i simd64_t;
+#define simd64_set1(x) _mm512_set1_epi64((long long)(x))
+#define simd64_add(a, b) _mm512_add_epi64(a, b)
+#define simd64_xor(a, b) _mm512_xor_si512(a, b)
+#define simd64_and(a, b) _mm512_and_si512(a, b)
+#define simd64_or(a, b) _mm512_or_si512(a, b)
+#define simd64_slli(a, k) avx512_slli_epi64(a, k)
+#define simd64_srli(a, k) avx512_srli_epi64(a, k)
+#define simd64_rotl(a, k) avx512_rol_epi64(a, k)
+#define simd64_mul_epu32(a, b) avx512_mul_epu32(a, b)
+#define simd64_storeu(p, a) _mm512_storeu_si512((void *)(p), a)
+#else
+#define SIMD64_LANES 4
+typedef __m256i simd64_t;
+#define simd64_set1(x) _mm256_set1_epi64x((long long)(x))
+#define simd64_add(a, b) _mm256_add_epi64(a, b)
+#define simd64_xor(a, b) _mm256_xor_si256(a, b)
+#define simd64_and(a, b) _mm256_and_si256(a, b)
+#define simd64_or(a, b) _mm256_or_si256(a, b)
+#define simd64_slli(a, k) _mm256_slli_epi64(a, k)
+#define simd64_srli(a, k) _mm256_srli_epi64(a, k)
+// no 64-bit rotate before AVX-512: shift both ways
+#define simd64_rotl(a, k)                                                      \
+  _mm256_or_si256(_mm256_slli_epi64(a, k), _mm256_srli_epi64(a, 64 - (k)))
+#define simd64_mul_epu32(a, b) _mm256_mul_epu32(a, b)
+#define simd64_storeu(p, a) _mm256_storeu_si256((__m256i *)(p), a)
+#endif
+
+// lane j holds base + (j + 1) * increment: the next SIMD64_LANES values of a
+// Weyl sequence that starts at base
+static inline simd64_t simd64_weyl(uint64_t base, uint64_t increment) {
+#if defined(__AVX512F__)
+  return _mm512_set_epi64(
+      (long long)(base + 8 * increment), (long long)(base + 7 * increment),
+      (long long)(base + 6 * increment), (long long)(base + 5 * increment),
+      (long long)(base + 4 * increment), (long long)(base + 3 * increment),
+      (long long)(base + 2 * increment), (long long)(base + increment));
+#else
+  return _mm256_set_epi64x(
+      (long long)(base + 4 * increment), (long long)(base + 3 * increment),
+      (long long)(base + 2 * increment), (long long)(base + increment));
+#endif
+}
+
+// low 64 bits of a * b
+static inline simd64_t simd64_mullo(simd64_t a, simd64_t b) {
+#if defined(__AVX512F__) && defined(__AVX512DQ__)
+  return _mm512_mullo_epi64(a, b);
+#else
+  // (ah * 2^32 + al) * (bh * 2^32 + bl) mod 2^64
+  simd64_t ll = simd64_mul_epu32(a, b);
+  simd64_t lh = simd64_mul_epu32(a, simd64_srli(b, 32));
+  simd64_t hl = simd64_mul_epu32(simd64_srli(a, 32), b);
+  return simd64_add(ll, simd64_slli(simd64_add(lh, hl), 32));
+#endif
+}
+
+// full 128-bit product of a * b, returns the low 64 bits and stores the
+// high 64 bits in *hi
+static inline simd64_t simd64_mulfull(simd64_t a, simd64_t b, simd64_t *hi) {
+#if defined(__AVX512F__) && defined(__AVX512IFMA__)
+  // with 52-bit limbs, a = a0 + a1 * 2^52 and b = b0 + b1 * 2^52:
+  // a * b = a0 b0 + (a0 b1 + a1 b0) * 2^52 + a1 b1 * 2^104
+  const simd64_t zero = _mm512_setzero_si512();
+  simd64_t a1 = simd64_srli(a, 52);
+  simd64_t b1 = simd64_srli(b, 52);
+  // vpmadd52 only reads the low 52 bits of its operands, so a and b stand in
+  // for a0 and b0
+  simd64_t lo52 = _mm512_madd52lo_epu64(zero, a, b);
+  simd64_t t1 = _mm512_madd52hi_epu64(zero, a, b);
+  t1 = _mm512_madd52lo_epu64(t1, a, b1);
+  t1 = _mm512_madd52lo_epu64(t1, a1, b);
+  simd64_t t2 = _mm512_madd52lo_epu64(zero, a1, b1);
+  t2 = _mm512_madd52hi_epu64(t2, a, b1);
+  t2 = _mm512_madd52hi_epu64(t2, a1, b);
+  // a * b = lo52 + t1 * 2^52 + t2 * 2^104
+  *hi = simd64_add(simd64_srli(t1, 12), simd64_slli(t2, 40));
+  return simd64_or(lo52, simd64_slli(t1, 52));
+#else
+  const simd64_t lo32 = simd64_set1(UINT64_C(0xFFFFFFFF));
+  simd64_t ah = simd64_srli(a, 32);
+  simd64_t bh = simd64_srli(b, 32);
+  simd64_t ll = simd64_mul_epu32(a, b);
+  simd64_t lh = simd64_mul_epu32(a, bh);
+  simd64_t hl = simd64_mul_epu32(ah, b);
+  simd64_t hh = simd64_mul_epu32(ah, bh);
+  // bits 32 to 63 of the product, plus the carry into the high word
+  simd64_t mid = simd64_add(simd64_add(simd64_srli(ll, 32), simd64_and(lh, lo32)),
+                            simd64_and(hl, lo32));
+  *hi = simd64_add(simd64_add(hh, simd64_srli(mid, 32)),
+                   simd64_add(simd64_srli(lh, 32), simd64_srli(hl, 32)));
+  return simd64_or(simd64_and(ll, lo32), simd64_slli(mid, 32));
+#endif
+}
+
+// Block ciphers computed one block per lane hold word j of every block in
+// vector xj. These store the blocks one after the other: x0[0], x1[0],
+// x0[1], x1[1], ... (2 words per block), or x0[0], x1[0], x2[0], x3[0],
+// x0[1], ... (4 words per block).
+static inline void simd64_store_blocks2(uint64_t *out, simd64_t x0, simd64_t x1) {
+#if defined(__AVX512F__)
+  const __m512i lo = _mm512_set_epi64(11, 3, 10, 2, 9, 1, 8, 0);
+  const __m512i hi = _mm512_set_epi64(15, 7, 14, 6, 13, 5, 12, 4);
+  simd64_storeu(out, _mm512_permutex2var_epi64(x0, lo, x1));
+  simd64_storeu(out + 8, _mm512_permutex2var_epi64(x0, hi, x1));
+#else
+  const __m256i a = _mm256_unpacklo_epi64(x0, x1); // blocks 0, 2
+  const __m256i b = _mm256_unpackhi_epi64(x0, x1); // blocks 1, 3
+  simd64_storeu(out, _mm256_permute2x128_si256(a, b, 0x20));
+  simd64_storeu(out + 4, _mm256_permute2x128_si256(a, b, 0x31));
+#endif
+}
+
+static inline void simd64_store_blocks4(uint64_t *out, simd64_t x0, simd64_t x1,
+                                        simd64_t x2, simd64_t x3) {
+#if defined(__AVX512F__)
+  const __m512i lo = _mm512_set_epi64(11, 3, 10, 2, 9, 1, 8, 0);
+  const __m512i hi = _mm512_set_epi64(15, 7, 14, 6, 13, 5, 12, 4);
+  const __m512i a = _mm512_permutex2var_epi64(x0, lo, x1); // x0, x1 of 0-3
+  const __m512i b = _mm512_permutex2var_epi64(x0, hi, x1); // x0, x1 of 4-7
+  const __m512i c = _mm512_permutex2var_epi64(x2, lo, x3); // x2, x3 of 0-3
+  const __m512i d = _mm512_permutex2var_epi64(x2, hi, x3); // x2, x3 of 4-7
+  const __m512i even = _mm512_set_epi64(11, 10, 3, 2, 9, 8, 1, 0);
+  const __m512i odd = _mm512_set_epi64(15, 14, 7, 6, 13, 12, 5, 4);
+  simd64_storeu(out, _mm512_permutex2var_epi64(a, even, c));
+  simd64_storeu(out + 8, _mm512_permutex2var_epi64(a, odd, c));
+  simd64_storeu(out + 16, _mm512_permutex2var_epi64(b, even, d));
+  simd64_storeu(out + 24, _mm512_permutex2var_epi64(b, odd, d));
+#else
+  const __m256i a = _mm256_unpacklo_epi64(x0, x1); // x0, x1 of 0 and 2
+  const __m256i b = _mm256_unpackhi_epi64(x0, x1); // x0, x1 of 1 and 3
+  const __m256i c = _mm256_unpacklo_epi64(x2, x3);
+  const __m256i d = _mm256_unpackhi_epi64(x2, x3);
+  simd64_storeu(out, _mm256_permute2x128_si256(a, c, 0x20));
+  simd64_storeu(out + 4, _mm256_permute2x128_si256(b, d, 0x20));
+  simd64_storeu(out + 8, _mm256_permute2x128_si256(a, c, 0x31));
+  simd64_storeu(out + 12, _mm256_permute2x128_si256(b, d, 0x31));
+#endif
+}
+
+#endif // __AVX2__
+#endif // SIMD64_H
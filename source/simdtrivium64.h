@@ -0,0 +1,178 @@
+#ifndef SIMDTRIVIUM64_H
+#define SIMDTRIVIUM64_H
+#if defined(__AVX2__)
+
+#include <immintrin.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "avx512warnings.h"
+
+// Vectorized trivium64: 8 independent trivium64 instances live side by side
+// in SIMD registers, in one AVX-512 vector or in two AVX2 vectors (lanes 0
+// to 3, then 4 to 7): the stream is the same whatever the instruction set.
+// They share the seed and use consecutive sequence numbers. Each step
+// advances all of them (including the 18 blank rounds of the seeding) and
+// returns one output per lane; the resulting stream interleaves the lanes
+// (out[0] is lane 0, out[1] is lane 1, ...). Lane i is exactly trivium64_r
+// on the state of trivium64_seed_r(seed, seq + i). Only AVX2 is required,
+// so this is a fast generator of cryptographic strength for processors
+// without AES instructions.
+
+#define SIMDTRIVIUM64_LANES 8
+#if defined(__AVX512F__)
+typedef __m512i simdtrivium64_vec;
+#define simdtrivium64_set1(x) _mm512_set1_epi64((long long)(x))
+#define simdtrivium64_xor(a, b) _mm512_xor_si512(a, b)
+#define simdtrivium64_and(a, b) _mm512_and_si512(a, b)
+#define simdtrivium64_slli(a, k) avx512_slli_epi64(a, k)
+#define simdtrivium64_srli(a, k) avx512_srli_epi64(a, k)
+#define simdtrivium64_loadu(p) _mm512_loadu_si512((const void *)(p))
+#define simdtrivium64_storeu(p, a) _mm512_storeu_si512((void *)(p), a)
+#else
+typedef struct {
+  __m256i lo, hi;
+} simdtrivium64_vec;
+
+static inline simdtrivium64_vec simdtrivium64_set1(uint64_t x) {
+  simdtrivium64_vec v = {_mm256_set1_epi64x((long long)x),
+                         _mm256_set1_epi64x((long long)x)};
+  return v;
+}
+static inline simdtrivium64_vec simdtrivium64_xor(simdtrivium64_vec a,
+                                                  simdtrivium64_vec b) {
+  simdtrivium64_vec v = {_mm256_xor_si256(a.lo, b.lo),
+                         _mm256_xor_si256(a.hi, b.hi)};
+  return v;
+}
+static inline simdtrivium64_vec simdtrivium64_and(simdtrivium64_vec a,
+                                                  simdtrivium64_vec b) {
+  simdtrivium64_vec v = {_mm256_and_si256(a.lo, b.lo),
+                         _mm256_and_si256(a.hi, b.hi)};
+  return v;
+}
+static inline simdtrivium64_vec simdtrivium64_slli(simdtrivium64_vec a, int k) {
+  simdtrivium64_vec v = {_mm256_slli_epi64(a.lo, k), _mm256_slli_epi64(a.hi, k)};
+  return v;
+}
+static inline simdtrivium64_vec simdtrivium64_srli(simdtrivium64_vec a, int k) {
+  simdtrivium64_vec v = {_mm256_srli_epi64(a.lo, k), _mm256_srli_epi64(a.hi, k)};
+  return v;
+}
+static inline simdtrivium64_vec simdtrivium64_loadu(const uint64_t *p) {
+  simdtrivium64_vec v = {_mm256_loadu_si256((const __m256i *)p),
+                         _mm256_loadu_si256((const __m256i *)(p + 4))};
+  return v;
+}
+static inline void simdtrivium64_storeu(uint64_t *p, simdtrivium64_vec a) {
+  _mm256_storeu_si256((__m256i *)p, a.lo);
+  _mm256_storeu_si256((__m256i *)(p + 4), a.hi);
+}
+#endif
+
+// bits k to k + 63 of the 128-bit register (hi, lo), as in trivium64_r:
+// (hi << (64 - k)) ^ (lo >> k)
+#define simdtrivium64_bits(hi, lo, k)                                          \
+  simdtrivium64_xor(simdtrivium64_slli(hi, 64 - (k)),                          \
+                    simdtrivium64_srli(lo, k))
+
+typedef struct {
+  simdtrivium64_vec s11, s12, s21, s22, s31, s32;
+  // outputs not yet handed out by simdtrivium64_r
+  uint64_t buffer[SIMDTRIVIUM64_LANES];
+  size_t offset;
+} simdtrivium64_state;
+
+static simdtrivium64_state g_simdtrivium64_state;
+
+// advances every lane, returns one output per lane
+static inline simdtrivium64_vec
+simdtrivium64_next_r(simdtrivium64_state *state) {
+  const simdtrivium64_vec s11 = state->s11, s12 = state->s12;
+  const simdtrivium64_vec s21 = state->s21, s22 = state->s22;
+  const simdtrivium64_vec s31 = state->s31, s32 = state->s32;
+  simdtrivium64_vec t1 = simdtrivium64_xor(simdtrivium64_bits(s12, s11, 2),
+                                           simdtrivium64_bits(s12, s11, 29));
+  simdtrivium64_vec t2 = simdtrivium64_xor(simdtrivium64_bits(s22, s21, 5),
+                                           simdtrivium64_bits(s22, s21, 20));
+  simdtrivium64_vec t3 = simdtrivium64_xor(simdtrivium64_bits(s32, s31, 2),
+                                           simdtrivium64_bits(s32, s31, 47));
+  const simdtrivium64_vec z =
+      simdtrivium64_xor(simdtrivium64_xor(t1, t2), t3);
+  t1 = simdtrivium64_xor(
+      t1, simdtrivium64_xor(simdtrivium64_and(simdtrivium64_bits(s12, s11, 27),
+                                              simdtrivium64_bits(s12, s11, 28)),
+                            simdtrivium64_bits(s22, s21, 14)));
+  t2 = simdtrivium64_xor(
+      t2, simdtrivium64_xor(simdtrivium64_and(simdtrivium64_bits(s22, s21, 18),
+                                              simdtrivium64_bits(s22, s21, 19)),
+                            simdtrivium64_bits(s32, s31, 23)));
+  t3 = simdtrivium64_xor(
+      t3, simdtrivium64_xor(simdtrivium64_and(simdtrivium64_bits(s32, s31, 45),
+                                              simdtrivium64_bits(s32, s31, 46)),
+                            simdtrivium64_bits(s12, s11, 5)));
+  state->s12 = s11; /* rotate */
+  state->s11 = t3;
+  state->s22 = s21;
+  state->s21 = t1;
+  state->s32 = s31;
+  state->s31 = t2;
+  return z;
+}
+
+// lane i gets the sequence number seq + i
+static inline void simdtrivium64_seed_r(simdtrivium64_state *state,
+                                        uint64_t seed, uint64_t seq) {
+  uint64_t seqs[SIMDTRIVIUM64_LANES];
+  for (int i = 0; i < SIMDTRIVIUM64_LANES; i++) seqs[i] = seq + i;
+  const simdtrivium64_vec zero = simdtrivium64_set1(0);
+  state->s11 = simdtrivium64_set1(seed);
+  state->s12 = zero;
+  state->s21 = simdtrivium64_loadu(seqs);
+  state->s22 = zero;
+  state->s31 = zero;
+  state->s32 = simdtrivium64_set1(0x700000000000);
+  for (int i = 0; i < 18; i++) /* blank rounds, all lanes at once */
+    simdtrivium64_next_r(state);
+  state->offset = SIMDTRIVIUM64_LANES;
+}
+
+// returns random number, one lane at a time
+static inline uint64_t simdtrivium64_r(simdtrivium64_state *state) {
+  if (__builtin_expect(state->offset >= SIMDTRIVIUM64_LANES, 0)) {
+    simdtrivium64_storeu(state->buffer, simdtrivium64_next_r(state));
+    state->offset = 0;
+  }
+  return state->buffer[state->offset++];
+}
+
+// writes the next n values of the stream, the same ones that n calls to
+// simdtrivium64_r would have returned
+static inline void simdtrivium64_fill_r(simdtrivium64_state *state,
+                                        uint64_t *out, size_t n) {
+  size_t i = 0;
+  while (i < n && state->offset < SIMDTRIVIUM64_LANES) {
+    out[i++] = state->buffer[state->offset++];
+  }
+  for (; i + SIMDTRIVIUM64_LANES <= n; i += SIMDTRIVIUM64_LANES) {
+    simdtrivium64_storeu(out + i, simdtrivium64_next_r(state));
+  }
+  for (; i < n; i++) {
+    out[i] = simdtrivium64_r(state);
+  }
+}
+
+static inline void simdtrivium64_seed(uint64_t seed, uint64_t seq) {
+  simdtrivium64_seed_r(&g_simdtrivium64_state, seed, seq);
+}
+
+static inline uint64_t simdtrivium64(void) {
+  return simdtrivium64_r(&g_simdtrivium64_state);
+}
+
+static inline void simdtrivium64_fill(uint64_t *out, size_t n) {
+  simdtrivium64_fill_r(&g_simdtrivium64_state, out, n);
+}
+
+#endif // __AVX2__
+#endif // SIMDTRIVIUM64_H
@@ -0,0 +1,149 @@
+#ifndef SIMDXOROSHIRO128PLUS_H
+#define SIMDXOROSHIRO128PLUS_H
+#if defined(__AVX2__)
+
+#include <immintrin.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "avx512warnings.h"
+#include "splitmix64.h"
+
+// Vectorized xoroshiro128plus: 8 independent xoroshiro128plus generators
+// live side by side in SIMD registers, in one AVX-512 vector or in two AVX2
+// vectors (lanes 0 to 3, then 4 to 7): the stream is the same whatever the
+// instruction set. Each step advances all of them and returns one output
+// per lane; the resulting stream interleaves the lanes (out[0] is lane 0,
+// out[1] is lane 1, ...). Every lane is exactly the scalar
+// xoroshiro128plus_r of xoroshiro128plus.h on its own state.
+
+#define SIMDXOROSHIRO128PLUS_LANES 8
+#if defined(__AVX512F__)
+typedef __m512i simdxoroshiro128plus_vec;
+#else
+typedef struct {
+  __m256i lo, hi;
+} simdxoroshiro128plus_vec;
+#endif
+
+typedef struct {
+  simdxoroshiro128plus_vec s0;
+  simdxoroshiro128plus_vec s1;
+  // outputs not yet handed out by simdxoroshiro128plus_r
+  uint64_t buffer[SIMDXOROSHIRO128PLUS_LANES];
+  size_t offset;
+} simdxoroshiro128plus_state;
+
+static simdxoroshiro128plus_state g_simdxoroshiro128plus_state;
+
+// lane i gets the (2i)-th and (2i+1)-th outputs of splitmix64 as its state,
+// so lane 0 matches xoroshiro128plus_seed_r with the same seed
+static inline void simdxoroshiro128plus_seed_r(simdxoroshiro128plus_state *state,
+                                               uint64_t seed) {
+  uint64_t s0[SIMDXOROSHIRO128PLUS_LANES];
+  uint64_t s1[SIMDXOROSHIRO128PLUS_LANES];
+  for (int i = 0; i < SIMDXOROSHIRO128PLUS_LANES; i++) {
+    s0[i] = splitmix64_r(&seed);
+    s1[i] = splitmix64_r(&seed);
+  }
+#if defined(__AVX512F__)
+  state->s0 = _mm512_loadu_si512((const void *)s0);
+  state->s1 = _mm512_loadu_si512((const void *)s1);
+#else
+  state->s0.lo = _mm256_loadu_si256((const __m256i *)s0);
+  state->s0.hi = _mm256_loadu_si256((const __m256i *)(s0 + 4));
+  state->s1.lo = _mm256_loadu_si256((const __m256i *)s1);
+  state->s1.hi = _mm256_loadu_si256((const __m256i *)(s1 + 4));
+#endif
+  state->offset = SIMDXOROSHIRO128PLUS_LANES;
+}
+
+#if !defined(__AVX512F__)
+// one step of four lanes
+static inline __m256i simdxoroshiro128plus_next4(__m256i *state0,
+                                                 __m256i *state1) {
+  const __m256i s0 = *state0;
+  __m256i s1 = *state1;
+  const __m256i result = _mm256_add_epi64(s0, s1);
+  s1 = _mm256_xor_si256(s1, s0);
+  // no 64-bit rotate before AVX-512: shift both ways
+  const __m256i r0 = _mm256_or_si256(_mm256_slli_epi64(s0, 55),
+                                     _mm256_srli_epi64(s0, 64 - 55));
+  *state0 = _mm256_xor_si256(_mm256_xor_si256(r0, s1),
+                             _mm256_slli_epi64(s1, 14)); // a, b
+  *state1 = _mm256_or_si256(_mm256_slli_epi64(s1, 36),
+                            _mm256_srli_epi64(s1, 64 - 36)); // c
+  return result;
+}
+#endif
+
+// advances every lane, returns one output per lane
+static inline simdxoroshiro128plus_vec
+simdxoroshiro128plus_next_r(simdxoroshiro128plus_state *state) {
+#if defined(__AVX512F__)
+  const __m512i s0 = state->s0;
+  __m512i s1 = state->s1;
+  const __m512i result = _mm512_add_epi64(s0, s1);
+  s1 = _mm512_xor_si512(s1, s0);
+  state->s0 = _mm512_xor_si512(_mm512_xor_si512(avx512_rol_epi64(s0, 55), s1),
+                               avx512_slli_epi64(s1, 14)); // a, b
+  state->s1 = avx512_rol_epi64(s1, 36);                    // c
+  return result;
+#else
+  simdxoroshiro128plus_vec result;
+  result.lo = simdxoroshiro128plus_next4(&state->s0.lo, &state->s1.lo);
+  result.hi = simdxoroshiro128plus_next4(&state->s0.hi, &state->s1.hi);
+  return result;
+#endif
+}
+
+static inline void simdxoroshiro128plus_store(uint64_t *out,
+                                              simdxoroshiro128plus_vec v) {
+#if defined(__AVX512F__)
+  _mm512_storeu_si512((void *)out, v);
+#else
+  _mm256_storeu_si256((__m256i *)out, v.lo);
+  _mm256_storeu_si256((__m256i *)(out + 4), v.hi);
+#endif
+}
+
+// returns random number, one lane at a time
+static inline uint64_t simdxoroshiro128plus_r(simdxoroshiro128plus_state *state) {
+  if (__builtin_expect(state->offset >= SIMDXOROSHIRO128PLUS_LANES, 0)) {
+    simdxoroshiro128plus_store(state->buffer,
+                               simdxoroshiro128plus_next_r(state));
+    state->offset = 0;
+  }
+  return state->buffer[state->offset++];
+}
+
+// writes the next n values of the stream, the same ones that n calls to
+// simdxoroshiro128plus_r would have returned
+static inline void simdxoroshiro128plus_fill_r(simdxoroshiro128plus_state *state,
+                                               uint64_t *out, size_t n) {
+  size_t i = 0;
+  while (i < n && state->offset < SIMDXOROSHIRO128PLUS_LANES) {
+    out[i++] = state->buffer[state->offset++];
+  }
+  for (; i + SIMDXOROSHIRO128PLUS_LANES <= n; i += SIMDXOROSHIRO128PLUS_LANES) {
+    simdxoroshiro128plus_store(out + i, simdxoroshiro128plus_next_r(state));
+  }
+  for (; i < n; i++) {
+    out[i] = simdxoroshiro128plus_r(state);
+  }
+}
+
+static inline void simdxoroshiro128plus_seed(uint64_t seed) {
+  simdxoroshiro128plus_seed_r(&g_simdxoroshiro128plus_state, seed);
+}
+
+static inline uint64_t simdxoroshiro128plus(void) {
+  return simdxoroshiro128plus_r(&g_simdxoroshiro128plus_state);
+}
+
+static inline void simdxoroshiro128plus_fill(uint64_t *out, size_t n) {
+  simdxoroshiro128plus_fill_r(&g_simdxoroshiro128plus_state, out, n);
+}
+
+#endif // __AVX2__
+#endif // SIMDXOROSHIRO128PLUS_H
@@ -0,0 +1,144 @@
+#ifndef SIMDXORSHIFT128PLUS_H
+#define SIMDXORSHIFT128PLUS_H
+#if defined(__AVX2__)
+
+#include <immintrin.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "avx512warnings.h"
+#include "splitmix64.h"
+
+// Vectorized xorshift128plus: 8 independent xorshift128plus generators live
+// side by side in SIMD registers, in one AVX-512 vector or in two AVX2
+// vectors (lanes 0 to 3, then 4 to 7): the stream is the same whatever the
+// instruction set. Each step advances all of them and returns one output
+// per lane; the resulting stream interleaves the lanes (out[0] is lane 0,
+// out[1] is lane 1, ...). Every lane is exactly the scalar
+// xorshift128plus_r of xorshift128plus.h on its own key.
+
+#define SIMDXORSHIFT128PLUS_LANES 8
+#if defined(__AVX512F__)
+typedef __m512i simdxorshift128plus_vec;
+#else
+typedef struct {
+  __m256i lo, hi;
+} simdxorshift128plus_vec;
+#endif
+
+typedef struct {
+  simdxorshift128plus_vec part1;
+  simdxorshift128plus_vec part2;
+  // outputs not yet handed out by simdxorshift128plus_r
+  uint64_t buffer[SIMDXORSHIFT128PLUS_LANES];
+  size_t offset;
+} simdxorshift128plus_state;
+
+static simdxorshift128plus_state g_simdxorshift128plus_state;
+
+// lane i gets the (2i)-th and (2i+1)-th outputs of splitmix64 as its key,
+// so lane 0 matches xorshift128plus_seed_r with the same seed
+static inline void simdxorshift128plus_seed_r(simdxorshift128plus_state *state,
+                                              uint64_t seed) {
+  uint64_t part1[SIMDXORSHIFT128PLUS_LANES];
+  uint64_t part2[SIMDXORSHIFT128PLUS_LANES];
+  for (int i = 0; i < SIMDXORSHIFT128PLUS_LANES; i++) {
+    part1[i] = splitmix64_r(&seed);
+    part2[i] = splitmix64_r(&seed);
+  }
+#if defined(__AVX512F__)
+  state->part1 = _mm512_loadu_si512((const void *)part1);
+  state->part2 = _mm512_loadu_si512((const void *)part2);
+#else
+  state->part1.lo = _mm256_loadu_si256((const __m256i *)part1);
+  state->part1.hi = _mm256_loadu_si256((const __m256i *)(part1 + 4));
+  state->part2.lo = _mm256_loadu_si256((const __m256i *)part2);
+  state->part2.hi = _mm256_loadu_si256((const __m256i *)(part2 + 4));
+#endif
+  state->offset = SIMDXORSHIFT128PLUS_LANES;
+}
+
+#if !defined(__AVX512F__)
+// one step of four lanes
+static inline __m256i simdxorshift128plus_next4(__m256i *part1,
+                                                __m256i *part2) {
+  __m256i s1 = *part1;
+  const __m256i s0 = *part2;
+  *part1 = s0;
+  s1 = _mm256_xor_si256(s1, _mm256_slli_epi64(s1, 23)); // a
+  *part2 = _mm256_xor_si256(
+      _mm256_xor_si256(_mm256_xor_si256(s1, s0), _mm256_srli_epi64(s1, 18)),
+      _mm256_srli_epi64(s0, 5)); // b, c
+  return _mm256_add_epi64(*part2, s0);
+}
+#endif
+
+// advances every lane, returns one output per lane
+static inline simdxorshift128plus_vec
+simdxorshift128plus_next_r(simdxorshift128plus_state *state) {
+#if defined(__AVX512F__)
+  __m512i s1 = state->part1;
+  const __m512i s0 = state->part2;
+  state->part1 = s0;
+  s1 = _mm512_xor_si512(s1, avx512_slli_epi64(s1, 23)); // a
+  state->part2 = _mm512_xor_si512(
+      _mm512_xor_si512(_mm512_xor_si512(s1, s0), avx512_srli_epi64(s1, 18)),
+      avx512_srli_epi64(s0, 5)); // b, c
+  return _mm512_add_epi64(state->part2, s0);
+#else
+  simdxorshift128plus_vec result;
+  result.lo = simdxorshift128plus_next4(&state->part1.lo, &state->part2.lo);
+  result.hi = simdxorshift128plus_next4(&state->part1.hi, &state->part2.hi);
+  return result;
+#endif
+}
+
+static inline void simdxorshift128plus_store(uint64_t *out,
+                                             simdxorshift128plus_vec v) {
+#if defined(__AVX512F__)
+  _mm512_storeu_si512((void *)out, v);
+#else
+  _mm256_storeu_si256((__m256i *)out, v.lo);
+  _mm256_storeu_si256((__m256i *)(out + 4), v.hi);
+#endif
+}
+
+// returns random number, one lane at a time
+static inline uint64_t simdxorshift128plus_r(simdxorshift128plus_state *state) {
+  if (__builtin_expect(state->offset >= SIMDXORSHIFT128PLUS_LANES, 0)) {
+    simdxorshift128plus_store(state->buffer, simdxorshift128plus_next_r(state));
+    state->offset = 0;
+  }
+  return state->buffer[state->offset++];
+}
+
+// writes the next n values of the stream, the same ones that n calls to
+// simdxorshift128plus_r would have returned
+static inline void simdxorshift128plus_fill_r(simdxorshift128plus_state *state,
+                                              uint64_t *out, size_t n) {
+  size_t i = 0;
+  while (i < n && state->offset < SIMDXORSHIFT128PLUS_LANES) {
+    out[i++] = state->buffer[state->offset++];
+  }
+  for (; i + SIMDXORSHIFT128PLUS_LANES <= n; i += SIMDXORSHIFT128PLUS_LANES) {
+    simdxorshift128plus_store(out + i, simdxorshift128plus_next_r(state));
+  }
+  for (; i < n; i++) {
+    out[i] = simdxorshift128plus_r(state);
+  }
+}
+
+static inline void simdxorshift128plus_seed(uint64_t seed) {
+  simdxorshift128plus_seed_r(&g_simdxorshift128plus_state, seed);
+}
+
+static inline uint64_t simdxorshift128plus(void) {
+  return simdxorshift128plus_r(&g_simdxorshift128plus_state);
+}
+
+static inline void simdxorshift128plus_fill(uint64_t *out, size_t n) {
+  simdxorshift128plus_fill_r(&g_simdxorshift128plus_state, out, n);
+}
+
+#endif // __AVX2__
+#endif // SIMDXORSHIFT128PLUS_H
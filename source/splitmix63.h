@@ -5,12 +5,20 @@
 may be seeded with any value. */
 
 #include <stdint.h>
+#include "fill.h"
 
 // state for splitmix63
-uint64_t splitmix63_x; /* The state can be seeded with any value. */
+static uint64_t splitmix63_x; /* The state can be seeded with any value. */
 
-// call this one before calling splitmix64
-static inline void splitmix63_seed(uint64_t seed) { splitmix63_x = seed; }
+// the state of splitmix63 is a single 64-bit word
+static inline void splitmix63_seed_r(uint64_t *state, uint64_t seed) {
+  *state = seed;
+}
+
+// call this one before calling splitmix63
+static inline void splitmix63_seed(uint64_t seed) {
+  splitmix63_seed_r(&splitmix63_x, seed);
+}
 
 // floor( ( (1+sqrt(5))/2 ) * 2**64 MOD 2**64)
 #define GOLDEN_GAMMA UINT64_C(0x9E3779B97F4A7C15)
@@ -38,4 +46,6 @@ static inline uint64_t splitmix63_stateless(uint64_t seed, uint64_t offset) {
   return splitmix63_r(&seed);
 }
 
+FILL_GENERIC(splitmix63, uint64_t, uint64_t, splitmix63_x)
+
 #endif // SPLITMIX63_H
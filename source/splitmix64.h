@@ -17,8 +17,11 @@ worldwide. This software is distributed without any warranty.
 
 See <http://creativecommons.org/publicdomain/zero/1.0/>. */
 
+#include <stddef.h>
 #include <stdint.h>
 
+#include "simd64.h"
+
 // original documentation by Vigna:
 /* This is a fixed-increment version of Java 8's SplittableRandom generator
    See http://dx.doi.org/10.1145/2714064.2660195 and
@@ -31,10 +34,17 @@ See <http://creativecommons.org/publicdomain/zero/1.0/>. */
    generator. */
 
 // state for splitmix64
-uint64_t splitmix64_x; /* The state can be seeded with any value. */
+static uint64_t splitmix64_x; /* The state can be seeded with any value. */
+
+// the state of splitmix64 is a single 64-bit word
+static inline void splitmix64_seed_r(uint64_t *state, uint64_t seed) {
+  *state = seed;
+}
 
 // call this one before calling splitmix64
-static inline void splitmix64_seed(uint64_t seed) { splitmix64_x = seed; }
+static inline void splitmix64_seed(uint64_t seed) {
+  splitmix64_seed_r(&splitmix64_x, seed);
+}
 
 // floor( ( (1+sqrt(5))/2 ) * 2**64 MOD 2**64)
 #define GOLDEN_GAMMA UINT64_C(0x9E3779B97F4A7C15)
@@ -67,4 +77,34 @@ static inline uint64_t splitmix64_stateless(uint64_t seed, uint64_t offset) {
   return splitmix64_r(&seed);
 }
 
+// writes the next n values of splitmix64, the same ones that n calls to
+// splitmix64_r(seed) would return; each value only depends on its position
+// in the Weyl sequence, so we compute several at once
+static inline void splitmix64_fill_r(uint64_t *seed, uint64_t *out, size_t n) {
+  size_t i = 0;
+#if defined(__AVX2__)
+  const simd64_t step = simd64_set1(SIMD64_LANES * GOLDEN_GAMMA);
+  const simd64_t m1 = simd64_set1(UINT64_C(0xBF58476D1CE4E5B9));
+  const simd64_t m2 = simd64_set1(UINT64_C(0x94D049BB133111EB));
+  simd64_t weyl = simd64_weyl(*seed, GOLDEN_GAMMA);
+  const size_t vectors = n - n % SIMD64_LANES;
+  for (; i < vectors; i += SIMD64_LANES) {
+    simd64_t z = weyl;
+    weyl = simd64_add(weyl, step);
+    z = simd64_mullo(simd64_xor(z, simd64_srli(z, 30)), m1);
+    z = simd64_mullo(simd64_xor(z, simd64_srli(z, 27)), m2);
+    simd64_storeu(out + i, simd64_xor(z, simd64_srli(z, 31)));
+  }
+  *seed += i * GOLDEN_GAMMA;
+#endif
+  for (; i < n; i++) {
+    out[i] = splitmix64_r(seed);
+  }
+}
+
+// writes the next n values of splitmix64, modifies splitmix64_x
+static inline void splitmix64_fill(uint64_t *out, size_t n) {
+  splitmix64_fill_r(&splitmix64_x, out, n);
+}
+
 #endif // SPLITMIX64_H
@@ -0,0 +1,357 @@
+#ifndef THREEFRY_H
+#define THREEFRY_H
+
+// Threefry2x64-20 and Threefry4x64-20, the counter-based generators of
+// Salmon, Moraes, Dror and Shaw, "Parallel random numbers: as easy as
+// 1, 2, 3" (SC 2011), derived from the Threefish block cipher. Block i of
+// the stream is the encryption of the counter {i, 0} (or {i, 0, 0, 0})
+// under the key, so any output can be computed directly from
+// (key, position) and several blocks can be computed at once. The block
+// functions produce the same outputs as the Random123 library. Threefry
+// only adds, rotates and xors: unlike philox4x64, its SIMD version needs
+// no 64-bit multiplication and runs on AVX2.
+//
+// The stream of 64-bit words is the concatenation of the blocks: word i is
+// output i % 2 of block i / 2 (threefry2x64) or output i % 4 of block i / 4
+// (threefry4x64). NAME_seek_r(state, i) moves the generator to word i in
+// constant time.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "simd64.h"
+#include "splitmix64.h"
+
+#define THREEFRY_KS_PARITY UINT64_C(0x1BD11BDAA9FC1A22)
+#define THREEFRY_ROUNDS 20
+
+static const int threefry2x64_rotations[8] = {16, 42, 12, 31, 16, 32, 24, 21};
+static const int threefry4x64_rotations[8][2] = {
+    {14, 16}, {52, 57}, {23, 40}, {5, 37}, {25, 33}, {46, 12}, {58, 22}, {32, 32}};
+
+static inline uint64_t threefry_rotl64(uint64_t x, int k) {
+  return (x << k) | (x >> (64 - k));
+}
+
+// encrypts the counter ctr under key, 20 rounds
+static inline void threefry2x64_block(const uint64_t ctr[2], const uint64_t key[2],
+                                      uint64_t out[2]) {
+  const uint64_t ks[3] = {key[0], key[1], THREEFRY_KS_PARITY ^ key[0] ^ key[1]};
+  uint64_t x0 = ctr[0] + ks[0];
+  uint64_t x1 = ctr[1] + ks[1];
+  for (int r = 0; r < THREEFRY_ROUNDS; r++) {
+    x0 += x1;
+    x1 = threefry_rotl64(x1, threefry2x64_rotations[r % 8]);
+    x1 ^= x0;
+    if (r % 4 == 3) { // key injection
+      const int i = (r + 1) / 4;
+      x0 += ks[i % 3];
+      x1 += ks[(i + 1) % 3] + i;
+    }
+  }
+  out[0] = x0;
+  out[1] = x1;
+}
+
+static inline void threefry4x64_block(const uint64_t ctr[4], const uint64_t key[4],
+                                      uint64_t out[4]) {
+  const uint64_t ks[5] = {key[0], key[1], key[2], key[3],
+                          THREEFRY_KS_PARITY ^ key[0] ^ key[1] ^ key[2] ^ key[3]};
+  uint64_t x0 = ctr[0] + ks[0];
+  uint64_t x1 = ctr[1] + ks[1];
+  uint64_t x2 = ctr[2] + ks[2];
+  uint64_t x3 = ctr[3] + ks[3];
+  for (int r = 0; r < THREEFRY_ROUNDS; r++) {
+    const int *rot = threefry4x64_rotations[r % 8];
+    if (r % 2 == 0) {
+      x0 += x1;
+      x1 = threefry_rotl64(x1, rot[0]);
+      x1 ^= x0;
+      x2 += x3;
+      x3 = threefry_rotl64(x3, rot[1]);
+      x3 ^= x2;
+    } else {
+      x0 += x3;
+      x3 = threefry_rotl64(x3, rot[0]);
+      x3 ^= x0;
+      x2 += x1;
+      x1 = threefry_rotl64(x1, rot[1]);
+      x1 ^= x2;
+    }
+    if (r % 4 == 3) { // key injection
+      const int i = (r + 1) / 4;
+      x0 += ks[i % 5];
+      x1 += ks[(i + 1) % 5];
+      x2 += ks[(i + 2) % 5];
+      x3 += ks[(i + 3) % 5] + i;
+    }
+  }
+  out[0] = x0;
+  out[1] = x1;
+  out[2] = x2;
+  out[3] = x3;
+}
+
+#if defined(__AVX2__)
+// SIMD64_LANES blocks at once, one per 64-bit lane. The rotations must be
+// immediates, so the rounds are spelled out.
+#define threefry_vround(a, b, c, d, ra, rb)                                    \
+  do {                                                                         \
+    a = simd64_add(a, b);                                                      \
+    b = simd64_xor(simd64_rotl(b, ra), a);                                     \
+    c = simd64_add(c, d);                                                      \
+    d = simd64_xor(simd64_rotl(d, rb), c);                                     \
+  } while (0)
+
+#define threefry2x64_vround(x0, x1, r)                                         \
+  do {                                                                         \
+    x0 = simd64_add(x0, x1);                                                   \
+    x1 = simd64_xor(simd64_rotl(x1, r), x0);                                   \
+  } while (0)
+
+#define threefry2x64_vinject(x0, x1, ks, i)                                    \
+  do {                                                                         \
+    x0 = simd64_add(x0, simd64_set1(ks[(i) % 3]));                             \
+    x1 = simd64_add(x1, simd64_set1(ks[((i) + 1) % 3] + (i)));                 \
+  } while (0)
+
+#define threefry2x64_v8rounds(x0, x1, ks, i)                                   \
+  do {                                                                         \
+    threefry2x64_vround(x0, x1, 16);                                           \
+    threefry2x64_vround(x0, x1, 42);                                           \
+    threefry2x64_vround(x0, x1, 12);                                           \
+    threefry2x64_vround(x0, x1, 31);                                           \
+    threefry2x64_vinject(x0, x1, ks, i);                                       \
+    threefry2x64_vround(x0, x1, 16);                                           \
+    threefry2x64_vround(x0, x1, 32);                                           \
+    threefry2x64_vround(x0, x1, 24);                                           \
+    threefry2x64_vround(x0, x1, 21);                                           \
+    threefry2x64_vinject(x0, x1, ks, (i) + 1);                                 \
+  } while (0)
+
+// blocks b to b + SIMD64_LANES - 1, written to out in order
+static inline void threefry2x64_blocks(const uint64_t key[2], uint64_t b,
+                                       uint64_t *out) {
+  const uint64_t ks[3] = {key[0], key[1], THREEFRY_KS_PARITY ^ key[0] ^ key[1]};
+  simd64_t x0 = simd64_weyl(b - 1 + ks[0], 1);
+  simd64_t x1 = simd64_set1(ks[1]);
+  threefry2x64_v8rounds(x0, x1, ks, 1);
+  threefry2x64_v8rounds(x0, x1, ks, 3);
+  threefry2x64_vround(x0, x1, 16);
+  threefry2x64_vround(x0, x1, 42);
+  threefry2x64_vround(x0, x1, 12);
+  threefry2x64_vround(x0, x1, 31);
+  threefry2x64_vinject(x0, x1, ks, 5);
+  simd64_store_blocks2(out, x0, x1);
+}
+
+#define threefry4x64_vinject(x0, x1, x2, x3, ks, i)                            \
+  do {                                                                         \
+    x0 = simd64_add(x0, simd64_set1(ks[(i) % 5]));                             \
+    x1 = simd64_add(x1, simd64_set1(ks[((i) + 1) % 5]));                       \
+    x2 = simd64_add(x2, simd64_set1(ks[((i) + 2) % 5]));                       \
+    x3 = simd64_add(x3, simd64_set1(ks[((i) + 3) % 5] + (i)));                 \
+  } while (0)
+
+// even rounds mix (x0, x1) and (x2, x3), odd rounds (x0, x3) and (x2, x1)
+#define threefry4x64_v8rounds(x0, x1, x2, x3, ks, i)                           \
+  do {                                                                         \
+    threefry_vround(x0, x1, x2, x3, 14, 16);                                   \
+    threefry_vround(x0, x3, x2, x1, 52, 57);                                   \
+    threefry_vround(x0, x1, x2, x3, 23, 40);                                   \
+    threefry_vround(x0, x3, x2, x1, 5, 37);                                    \
+    threefry4x64_vinject(x0, x1, x2, x3, ks, i);                               \
+    threefry_vround(x0, x1, x2, x3, 25, 33);                                   \
+    threefry_vround(x0, x3, x2, x1, 46, 12);                                   \
+    threefry_vround(x0, x1, x2, x3, 58, 22);                                   \
+    threefry_vround(x0, x3, x2, x1, 32, 32);                                   \
+    threefry4x64_vinject(x0, x1, x2, x3, ks, (i) + 1);                         \
+  } while (0)
+
+static inline void threefry4x64_blocks(const uint64_t key[4], uint64_t b,
+                                       uint64_t *out) {
+  const uint64_t ks[5] = {key[0], key[1], key[2], key[3],
+                          THREEFRY_KS_PARITY ^ key[0] ^ key[1] ^ key[2] ^ key[3]};
+  simd64_t x0 = simd64_weyl(b - 1 + ks[0], 1);
+  simd64_t x1 = simd64_set1(ks[1]);
+  simd64_t x2 = simd64_set1(ks[2]);
+  simd64_t x3 = simd64_set1(ks[3]);
+  threefry4x64_v8rounds(x0, x1, x2, x3, ks, 1);
+  threefry4x64_v8rounds(x0, x1, x2, x3, ks, 3);
+  threefry_vround(x0, x1, x2, x3, 14, 16);
+  threefry_vround(x0, x3, x2, x1, 52, 57);
+  threefry_vround(x0, x1, x2, x3, 23, 40);
+  threefry_vround(x0, x3, x2, x1, 5, 37);
+  threefry4x64_vinject(x0, x1, x2, x3, ks, 5);
+  simd64_store_blocks4(out, x0, x1, x2, x3);
+}
+#endif // __AVX2__
+
+////
+// threefry2x64
+////
+
+typedef struct {
+  uint64_t key[2];
+  uint64_t counter; // next block
+  uint64_t buffer[2];
+  size_t offset;
+} threefry2x64_state;
+
+static threefry2x64_state g_threefry2x64_state;
+
+static inline void threefry2x64_block_at(const threefry2x64_state *state,
+                                         uint64_t block, uint64_t out[2]) {
+  const uint64_t ctr[2] = {block, 0};
+  threefry2x64_block(ctr, state->key, out);
+}
+
+static inline void threefry2x64_seed_r(threefry2x64_state *state, uint64_t seed) {
+  state->key[0] = splitmix64_r(&seed);
+  state->key[1] = splitmix64_r(&seed);
+  state->counter = 0;
+  state->offset = 2;
+}
+
+// moves to word index of the stream
+static inline void threefry2x64_seek_r(threefry2x64_state *state,
+                                       uint64_t index) {
+  threefry2x64_block_at(state, index / 2, state->buffer);
+  state->counter = index / 2 + 1;
+  state->offset = index % 2;
+}
+
+// word index of the stream, without changing the state
+static inline uint64_t threefry2x64_at_r(const threefry2x64_state *state,
+                                         uint64_t index) {
+  uint64_t block[2];
+  threefry2x64_block_at(state, index / 2, block);
+  return block[index % 2];
+}
+
+static inline uint64_t threefry2x64_r(threefry2x64_state *state) {
+  if (__builtin_expect(state->offset >= 2, 0)) {
+    threefry2x64_block_at(state, state->counter++, state->buffer);
+    state->offset = 0;
+  }
+  return state->buffer[state->offset++];
+}
+
+// writes the next n words of the stream, the same ones that n calls to
+// threefry2x64_r would have returned
+static inline void threefry2x64_fill_r(threefry2x64_state *state,
+                                       uint64_t *out, size_t n) {
+  size_t i = 0;
+  while (i < n && state->offset < 2) {
+    out[i++] = state->buffer[state->offset++];
+  }
+#if defined(__AVX2__)
+  for (; i + 2 * SIMD64_LANES <= n; i += 2 * SIMD64_LANES) {
+    threefry2x64_blocks(state->key, state->counter, out + i);
+    state->counter += SIMD64_LANES;
+  }
+#endif
+  for (; i + 2 <= n; i += 2) {
+    threefry2x64_block_at(state, state->counter++, out + i);
+  }
+  for (; i < n; i++) {
+    out[i] = threefry2x64_r(state);
+  }
+}
+
+static inline void threefry2x64_seed(uint64_t seed) {
+  threefry2x64_seed_r(&g_threefry2x64_state, seed);
+}
+
+static inline uint64_t threefry2x64(void) {
+  return threefry2x64_r(&g_threefry2x64_state);
+}
+
+static inline void threefry2x64_fill(uint64_t *out, size_t n) {
+  threefry2x64_fill_r(&g_threefry2x64_state, out, n);
+}
+
+////
+// threefry4x64
+////
+
+typedef struct {
+  uint64_t key[4];
+  uint64_t counter; // next block
+  uint64_t buffer[4];
+  size_t offset;
+} threefry4x64_state;
+
+static threefry4x64_state g_threefry4x64_state;
+
+static inline void threefry4x64_block_at(const threefry4x64_state *state,
+                                         uint64_t block, uint64_t out[4]) {
+  const uint64_t ctr[4] = {block, 0, 0, 0};
+  threefry4x64_block(ctr, state->key, out);
+}
+
+static inline void threefry4x64_seed_r(threefry4x64_state *state, uint64_t seed) {
+  for (int i = 0; i < 4; i++) state->key[i] = splitmix64_r(&seed);
+  state->counter = 0;
+  state->offset = 4;
+}
+
+// moves to word index of the stream
+static inline void threefry4x64_seek_r(threefry4x64_state *state,
+                                       uint64_t index) {
+  threefry4x64_block_at(state, index / 4, state->buffer);
+  state->counter = index / 4 + 1;
+  state->offset = index % 4;
+}
+
+// word index of the stream, without changing the state
+static inline uint64_t threefry4x64_at_r(const threefry4x64_state *state,
+                                         uint64_t index) {
+  uint64_t block[4];
+  threefry4x64_block_at(state, index / 4, block);
+  return block[index % 4];
+}
+
+static inline uint64_t threefry4x64_r(threefry4x64_state *state) {
+  if (__builtin_expect(state->offset >= 4, 0)) {
+    threefry4x64_block_at(state, state->counter++, state->buffer);
+    state->offset = 0;
+  }
+  return state->buffer[state->offset++];
+}
+
+// writes the next n words of the stream, the same ones that n calls to
+// threefry4x64_r would have returned
+static inline void threefry4x64_fill_r(threefry4x64_state *state,
+                                       uint64_t *out, size_t n) {
+  size_t i = 0;
+  while (i < n && state->offset < 4) {
+    out[i++] = state->buffer[state->offset++];
+  }
+#if defined(__AVX2__)
+  for (; i + 4 * SIMD64_LANES <= n; i += 4 * SIMD64_LANES) {
+    threefry4x64_blocks(state->key, state->counter, out + i);
+    state->counter += SIMD64_LANES;
+  }
+#endif
+  for (; i + 4 <= n; i += 4) {
+    threefry4x64_block_at(state, state->counter++, out + i);
+  }
+  for (; i < n; i++) {
+    out[i] = threefry4x64_r(state);
+  }
+}
+
+static inline void threefry4x64_seed(uint64_t seed) {
+  threefry4x64_seed_r(&g_threefry4x64_state, seed);
+}
+
+static inline uint64_t threefry4x64(void) {
+  return threefry4x64_r(&g_threefry4x64_state);
+}
+
+static inline void threefry4x64_fill(uint64_t *out, size_t n) {
+  threefry4x64_fill_r(&g_threefry4x64_state, out, n);
+}
+
+#endif // THREEFRY_H
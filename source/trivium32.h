@@ -1,3 +1,6 @@
+#ifndef TRIVIUM32_H
+#define TRIVIUM32_H
+
 /*
  * PRNG-style implementation of trivium.
  * Author: Charles Bouillaguet (charles.bouillaguet@lip6.fr).
@@ -15,27 +18,30 @@
  * The generator takes a 64-bit seed and a 64-bit "sequence number" (this allows
  * to generate independant sequences with the same seed). */
 #include <inttypes.h>
+#include "fill.h"
+
+typedef struct {
+  uint32_t s11, s12, s13, s21, s22, s23, s31, s32, s33, s34;
+} trivium32_state;
 
-uint32_t trivium32_s11, trivium32_s12, trivium32_s13, trivium32_s21,
-    trivium32_s22, trivium32_s23, trivium32_s31, trivium32_s32, trivium32_s33,
-    trivium32_s34; /* global internal state */
+static trivium32_state g_trivium32_state; /* global internal state */
 
-static inline uint32_t trivium32(void) {
-  uint32_t s66 = (trivium32_s13 << 30) ^ (trivium32_s12 >> 2);
-  uint32_t s93 = (trivium32_s13 << 3) ^ (trivium32_s12 >> 29);
-  uint32_t s162 = (trivium32_s23 << 27) ^ (trivium32_s22 >> 5);
-  uint32_t s177 = (trivium32_s23 << 12) ^ (trivium32_s22 >> 20);
-  uint32_t s243 = (trivium32_s33 << 30) ^ (trivium32_s32 >> 2);
-  uint32_t s288 = (trivium32_s34 << 17) ^ (trivium32_s33 >> 15);
-  uint32_t s91 = (trivium32_s13 << 5) ^ (trivium32_s12 >> 27);
-  uint32_t s92 = (trivium32_s13 << 4) ^ (trivium32_s12 >> 28);
-  uint32_t s171 = (trivium32_s23 << 18) ^ (trivium32_s22 >> 14);
-  uint32_t s175 = (trivium32_s23 << 14) ^ (trivium32_s22 >> 18);
-  uint32_t s176 = (trivium32_s23 << 13) ^ (trivium32_s22 >> 19);
-  uint32_t s264 = (trivium32_s33 << 9) ^ (trivium32_s32 >> 23);
-  uint32_t s286 = (trivium32_s34 << 19) ^ (trivium32_s33 >> 13);
-  uint32_t s287 = (trivium32_s34 << 18) ^ (trivium32_s33 >> 14);
-  uint32_t s69 = (trivium32_s13 << 27) ^ (trivium32_s12 >> 5);
+static inline uint32_t trivium32_r(trivium32_state *state) {
+  uint32_t s66 = (state->s13 << 30) ^ (state->s12 >> 2);
+  uint32_t s93 = (state->s13 << 3) ^ (state->s12 >> 29);
+  uint32_t s162 = (state->s23 << 27) ^ (state->s22 >> 5);
+  uint32_t s177 = (state->s23 << 12) ^ (state->s22 >> 20);
+  uint32_t s243 = (state->s33 << 30) ^ (state->s32 >> 2);
+  uint32_t s288 = (state->s34 << 17) ^ (state->s33 >> 15);
+  uint32_t s91 = (state->s13 << 5) ^ (state->s12 >> 27);
+  uint32_t s92 = (state->s13 << 4) ^ (state->s12 >> 28);
+  uint32_t s171 = (state->s23 << 18) ^ (state->s22 >> 14);
+  uint32_t s175 = (state->s23 << 14) ^ (state->s22 >> 18);
+  uint32_t s176 = (state->s23 << 13) ^ (state->s22 >> 19);
+  uint32_t s264 = (state->s33 << 9) ^ (state->s32 >> 23);
+  uint32_t s286 = (state->s34 << 19) ^ (state->s33 >> 13);
+  uint32_t s287 = (state->s34 << 18) ^ (state->s33 >> 14);
+  uint32_t s69 = (state->s13 << 27) ^ (state->s12 >> 5);
   uint32_t t1 = s66 ^ s93; /* update */
   uint32_t t2 = s162 ^ s177;
   uint32_t t3 = s243 ^ s288;
@@ -43,30 +49,41 @@ static inline uint32_t trivium32(void) {
   t1 ^= (s91 & s92) ^ s171;
   t2 ^= (s175 & s176) ^ s264;
   t3 ^= (s286 & s287) ^ s69;
-  trivium32_s13 = trivium32_s12; /* rotate */
-  trivium32_s12 = trivium32_s11;
-  trivium32_s11 = t3;
-  trivium32_s23 = trivium32_s22;
-  trivium32_s22 = trivium32_s21;
-  trivium32_s21 = t1;
-  trivium32_s34 = trivium32_s33;
-  trivium32_s33 = trivium32_s32;
-  trivium32_s32 = trivium32_s31;
-  trivium32_s31 = t2;
+  state->s13 = state->s12; /* rotate */
+  state->s12 = state->s11;
+  state->s11 = t3;
+  state->s23 = state->s22;
+  state->s22 = state->s21;
+  state->s21 = t1;
+  state->s34 = state->s33;
+  state->s33 = state->s32;
+  state->s32 = state->s31;
+  state->s31 = t2;
   return z;
 }
 
-void trivium32_seed(uint64_t seed, uint64_t seq) {
-  trivium32_s11 = seed;
-  trivium32_s12 = seed >> 32;
-  trivium32_s13 = 0;
-  trivium32_s21 = seq;
-  trivium32_s22 = seq >> 32;
-  trivium32_s23 = 0;
-  trivium32_s31 = 0;
-  trivium32_s32 = 0;
-  trivium32_s33 = 0;
-  trivium32_s34 = 0x7000;
+static inline void trivium32_seed_r(trivium32_state *state, uint64_t seed,
+                                    uint64_t seq) {
+  state->s11 = seed;
+  state->s12 = seed >> 32;
+  state->s13 = 0;
+  state->s21 = seq;
+  state->s22 = seq >> 32;
+  state->s23 = 0;
+  state->s31 = 0;
+  state->s32 = 0;
+  state->s33 = 0;
+  state->s34 = 0x7000;
   for (int i = 0; i < 36; i++) /* blank rounds */
-    trivium32();
-}
\ No newline at end of file
+    trivium32_r(state);
+}
+
+static inline uint32_t trivium32(void) { return trivium32_r(&g_trivium32_state); }
+
+static inline void trivium32_seed(uint64_t seed, uint64_t seq) {
+  trivium32_seed_r(&g_trivium32_state, seed, seq);
+}
+
+FILL_GENERIC(trivium32, trivium32_state, uint32_t, g_trivium32_state)
+
+#endif // TRIVIUM32_H
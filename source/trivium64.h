@@ -1,3 +1,6 @@
+#ifndef TRIVIUM64_H
+#define TRIVIUM64_H
+
 /*
  * PRNG-style implementation of trivium (64-bit version).
  * Author: Charles Bouillaguet (charles.bouillaguet@lip6.fr).
@@ -15,26 +18,30 @@
  * to generate independant sequences with the same seed).
  */
 #include <inttypes.h>
+#include "fill.h"
+
+typedef struct {
+  uint64_t s11, s12, s21, s22, s31, s32;
+} trivium64_state;
+
+static trivium64_state g_trivium64_state; /* global internal state */
 
-uint64_t trivium64_s11, trivium64_s12, trivium64_s21, trivium64_s22,
-    trivium64_s31, trivium64_s32; /* global internal state */
-
-static inline uint64_t trivium64(void) {
-  uint64_t s66 = (trivium64_s12 << 62) ^ (trivium64_s11 >> 2);
-  uint64_t s93 = (trivium64_s12 << 35) ^ (trivium64_s11 >> 29);
-  uint64_t s162 = (trivium64_s22 << 59) ^ (trivium64_s21 >> 5);
-  uint64_t s177 = (trivium64_s22 << 44) ^ (trivium64_s21 >> 20);
-  uint64_t s243 = (trivium64_s32 << 62) ^ (trivium64_s31 >> 2);
-  uint64_t s288 = (trivium64_s32 << 17) ^ (trivium64_s31 >> 47);
-  uint64_t s91 = (trivium64_s12 << 37) ^ (trivium64_s11 >> 27);
-  uint64_t s92 = (trivium64_s12 << 36) ^ (trivium64_s11 >> 28);
-  uint64_t s171 = (trivium64_s22 << 50) ^ (trivium64_s21 >> 14);
-  uint64_t s175 = (trivium64_s22 << 46) ^ (trivium64_s21 >> 18);
-  uint64_t s176 = (trivium64_s22 << 45) ^ (trivium64_s21 >> 19);
-  uint64_t s264 = (trivium64_s32 << 41) ^ (trivium64_s31 >> 23);
-  uint64_t s286 = (trivium64_s32 << 19) ^ (trivium64_s31 >> 45);
-  uint64_t s287 = (trivium64_s32 << 18) ^ (trivium64_s31 >> 46);
-  uint64_t s69 = (trivium64_s12 << 59) ^ (trivium64_s11 >> 5);
+static inline uint64_t trivium64_r(trivium64_state *state) {
+  uint64_t s66 = (state->s12 << 62) ^ (state->s11 >> 2);
+  uint64_t s93 = (state->s12 << 35) ^ (state->s11 >> 29);
+  uint64_t s162 = (state->s22 << 59) ^ (state->s21 >> 5);
+  uint64_t s177 = (state->s22 << 44) ^ (state->s21 >> 20);
+  uint64_t s243 = (state->s32 << 62) ^ (state->s31 >> 2);
+  uint64_t s288 = (state->s32 << 17) ^ (state->s31 >> 47);
+  uint64_t s91 = (state->s12 << 37) ^ (state->s11 >> 27);
+  uint64_t s92 = (state->s12 << 36) ^ (state->s11 >> 28);
+  uint64_t s171 = (state->s22 << 50) ^ (state->s21 >> 14);
+  uint64_t s175 = (state->s22 << 46) ^ (state->s21 >> 18);
+  uint64_t s176 = (state->s22 << 45) ^ (state->s21 >> 19);
+  uint64_t s264 = (state->s32 << 41) ^ (state->s31 >> 23);
+  uint64_t s286 = (state->s32 << 19) ^ (state->s31 >> 45);
+  uint64_t s287 = (state->s32 << 18) ^ (state->s31 >> 46);
+  uint64_t s69 = (state->s12 << 59) ^ (state->s11 >> 5);
   uint64_t t1 = s66 ^ s93; /* update */
   uint64_t t2 = s162 ^ s177;
   uint64_t t3 = s243 ^ s288;
@@ -42,22 +49,33 @@ static inline uint64_t trivium64(void) {
   t1 ^= (s91 & s92) ^ s171;
   t2 ^= (s175 & s176) ^ s264;
   t3 ^= (s286 & s287) ^ s69;
-  trivium64_s12 = trivium64_s11; /* rotate */
-  trivium64_s11 = t3;
-  trivium64_s22 = trivium64_s21;
-  trivium64_s21 = t1;
-  trivium64_s32 = trivium64_s31;
-  trivium64_s31 = t2;
+  state->s12 = state->s11; /* rotate */
+  state->s11 = t3;
+  state->s22 = state->s21;
+  state->s21 = t1;
+  state->s32 = state->s31;
+  state->s31 = t2;
   return z;
 }
 
-void trivium64_seed(uint64_t seed, uint64_t seq) {
-  trivium64_s11 = seed;
-  trivium64_s12 = 0;
-  trivium64_s21 = seq;
-  trivium64_s22 = 0;
-  trivium64_s31 = 0;
-  trivium64_s32 = 0x700000000000;
+static inline void trivium64_seed_r(trivium64_state *state, uint64_t seed,
+                                    uint64_t seq) {
+  state->s11 = seed;
+  state->s12 = 0;
+  state->s21 = seq;
+  state->s22 = 0;
+  state->s31 = 0;
+  state->s32 = 0x700000000000;
   for (int i = 0; i < 18; i++) /* blank rounds */
-    trivium64();
-}
\ No newline at end of file
+    trivium64_r(state);
+}
+
+static inline uint64_t trivium64(void) { return trivium64_r(&g_trivium64_state); }
+
+static inline void trivium64_seed(uint64_t seed, uint64_t seq) {
+  trivium64_seed_r(&g_trivium64_state, seed, seq);
+}
+
+FILL_GENERIC(trivium64, trivium64_state, uint64_t, g_trivium64_state)
+
+#endif // TRIVIUM64_H
@@ -1,14 +1,25 @@
+#ifndef W1RAND_H
+#define W1RAND_H
+
 // w1rand: a wyrand-style PRNG by wangyi-fudan.
 // Uses a single constant for both the increment and the XOR mix.
 // See: https://github.com/alvoskov/SmokeRand/blob/devel/generators/w1rand.c
 //      https://github.com/lemire/testingRNG/issues/28
+#include <stddef.h>
 #include <stdint.h>
 
+#include "simd64.h"
+
 static const uint64_t w1rand_c = UINT64_C(0xd07ebc63274654c7);
 
-uint64_t w1rand_x;
+static uint64_t w1rand_x;
 
-static inline void w1rand_seed(uint64_t seed) { w1rand_x = seed; }
+// the state of w1rand is a single 64-bit word
+static inline void w1rand_seed_r(uint64_t *state, uint64_t seed) {
+  *state = seed;
+}
+
+static inline void w1rand_seed(uint64_t seed) { w1rand_seed_r(&w1rand_x, seed); }
 
 static inline uint64_t w1rand_stateless(uint64_t *s) {
   *s += w1rand_c;
@@ -16,6 +27,38 @@ static inline uint64_t w1rand_stateless(uint64_t *s) {
   return (uint64_t)(t >> 64) ^ (uint64_t)t;
 }
 
-static inline uint64_t w1rand(void) { return w1rand_stateless(&w1rand_x); }
+// returns random number, modifies *state
+static inline uint64_t w1rand_r(uint64_t *state) { return w1rand_stateless(state); }
+
+static inline uint64_t w1rand(void) { return w1rand_r(&w1rand_x); }
+
+// writes the next n values of w1rand, the same ones that n calls to
+// w1rand_r(state) would return, several at a time
+static inline void w1rand_fill_r(uint64_t *state, uint64_t *out, size_t n) {
+  size_t i = 0;
+#if defined(SIMD64_FAST_MULFULL)
+  const simd64_t step = simd64_set1(SIMD64_LANES * w1rand_c);
+  const simd64_t c = simd64_set1(w1rand_c);
+  simd64_t weyl = simd64_weyl(*state, w1rand_c);
+  const size_t vectors = n - n % SIMD64_LANES;
+  for (; i < vectors; i += SIMD64_LANES) {
+    simd64_t s = weyl;
+    weyl = simd64_add(weyl, step);
+    simd64_t hi;
+    simd64_t lo = simd64_mulfull(s, simd64_xor(s, c), &hi);
+    simd64_storeu(out + i, simd64_xor(hi, lo));
+  }
+  *state += i * w1rand_c;
+#endif
+  for (; i < n; i++) {
+    out[i] = w1rand_stateless(state);
+  }
+}
+
+static inline void w1rand_fill(uint64_t *out, size_t n) {
+  w1rand_fill_r(&w1rand_x, out, n);
+}
 
 static inline uint32_t w1rand_cast32(void) { return (uint32_t)w1rand(); }
+
+#endif // W1RAND_H
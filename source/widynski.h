@@ -2,25 +2,38 @@
 #define WIDYNSKI_H
 
 #include <stdint.h>
+#include "fill.h"
 // based on https://arxiv.org/pdf/1704.00358.pdf
-static uint64_t g_widynski_x;
-static uint64_t g_widynski_w;
-static uint64_t g_widynski_s;
+typedef struct {
+  uint64_t x;
+  uint64_t w;
+  uint64_t s;
+} widynski_state;
 
-static inline void widynski_seed(uint64_t seed) {
-  g_widynski_w = 0;
-  g_widynski_x = 0;
-  g_widynski_s = seed;
-  g_widynski_s |= 1;
-  if ((g_widynski_s >> 32) == 0)
-    g_widynski_s = g_widynski_s | (g_widynski_s << 32);
+static widynski_state g_widynski_state;
+
+static inline void widynski_seed_r(widynski_state *state, uint64_t seed) {
+  state->w = 0;
+  state->x = 0;
+  state->s = seed;
+  state->s |= 1;
+  if ((state->s >> 32) == 0)
+    state->s = state->s | (state->s << 32);
 }
 
-static inline uint32_t widynski() {
-  g_widynski_x *= g_widynski_x;
-  g_widynski_x += (g_widynski_w += g_widynski_s);
-  g_widynski_x = (g_widynski_x >> 32) | (g_widynski_x << 32);
-  return g_widynski_x;
+static inline uint32_t widynski_r(widynski_state *state) {
+  state->x *= state->x;
+  state->x += (state->w += state->s);
+  state->x = (state->x >> 32) | (state->x << 32);
+  return state->x;
 }
 
+static inline void widynski_seed(uint64_t seed) {
+  widynski_seed_r(&g_widynski_state, seed);
+}
+
+static inline uint32_t widynski() { return widynski_r(&g_widynski_state); }
+
+FILL_GENERIC(widynski, widynski_state, uint32_t, g_widynski_state)
+
 #endif
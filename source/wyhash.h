@@ -1,11 +1,24 @@
+#ifndef WYHASH_H
+#define WYHASH_H
+
 // adapted to this project by D. Lemire, from https://github.com/wangyi-fudan/wyhash/blob/master/wyhash.h
 // This uses mum hashing.
+#include <stddef.h>
 #include <stdint.h>
+
+#include "simd64.h"
 // state for wyhash64
-uint64_t wyhash64_x; /* The state can be seeded with any value. */
+static uint64_t wyhash64_x; /* The state can be seeded with any value. */
+
+// the state of wyhash64 is a single 64-bit word
+static inline void wyhash64_seed_r(uint64_t *state, uint64_t seed) {
+  *state = seed;
+}
 
 // call wyhash64_seed before calling wyhash64
-static inline void wyhash64_seed(uint64_t seed) { wyhash64_x = seed; }
+static inline void wyhash64_seed(uint64_t seed) {
+  wyhash64_seed_r(&wyhash64_x, seed);
+}
 
 static inline uint64_t wyhash64_stateless(uint64_t *seed) {
   *seed += UINT64_C(0x60bee2bee120fc15);
@@ -17,9 +30,48 @@ static inline uint64_t wyhash64_stateless(uint64_t *seed) {
   return m2;
 }
 
+// returns random number, modifies *state
+static inline uint64_t wyhash64_r(uint64_t *state) {
+  return wyhash64_stateless(state);
+}
+
 // returns random number, modifies wyhash64_x
-static inline uint64_t wyhash64(void) { return wyhash64_stateless(&wyhash64_x); }
+static inline uint64_t wyhash64(void) { return wyhash64_r(&wyhash64_x); }
+
+// writes the next n values of wyhash64, the same ones that n calls to
+// wyhash64_r(state) would return; each value only depends on its position in
+// the Weyl sequence, so we compute several at once
+static inline void wyhash64_fill_r(uint64_t *state, uint64_t *out, size_t n) {
+  size_t i = 0;
+  // two dependent 128-bit products per value: only worth it with IFMA
+#if defined(SIMD64_FAST_MULFULL) && defined(__AVX512IFMA__)
+  const simd64_t step = simd64_set1(SIMD64_LANES * UINT64_C(0x60bee2bee120fc15));
+  const simd64_t m1 = simd64_set1(UINT64_C(0xa3b195354a39b70d));
+  const simd64_t m2 = simd64_set1(UINT64_C(0x1b03738712fad5c9));
+  simd64_t weyl = simd64_weyl(*state, UINT64_C(0x60bee2bee120fc15));
+  const size_t vectors = n - n % SIMD64_LANES;
+  for (; i < vectors; i += SIMD64_LANES) {
+    simd64_t s = weyl;
+    weyl = simd64_add(weyl, step);
+    simd64_t hi;
+    simd64_t lo = simd64_mulfull(s, m1, &hi);
+    lo = simd64_mulfull(simd64_xor(hi, lo), m2, &hi);
+    simd64_storeu(out + i, simd64_xor(hi, lo));
+  }
+  *state += i * UINT64_C(0x60bee2bee120fc15);
+#endif
+  for (; i < n; i++) {
+    out[i] = wyhash64_stateless(state);
+  }
+}
+
+// writes the next n values of wyhash64, modifies wyhash64_x
+static inline void wyhash64_fill(uint64_t *out, size_t n) {
+  wyhash64_fill_r(&wyhash64_x, out, n);
+}
 
 // returns the 32 least significant bits of a call to wyhash64
 // this is a simple function call followed by a cast
 static inline uint32_t wyhash64_cast32(void) { return (uint32_t)wyhash64(); }
+
+#endif // WYHASH_H
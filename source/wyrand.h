@@ -1,11 +1,22 @@
+#ifndef WYRAND_H
+#define WYRAND_H
+
 // adapted to this project by D. Lemire, from https://github.com/wangyi-fudan/wyhash/blob/master/wyhash.h
 // This uses mum hashing.
+#include <stddef.h>
 #include <stdint.h>
+
+#include "simd64.h"
 // state for wyrand
-uint64_t wyrand_x; /* The state can be seeded with any value. */
+static uint64_t wyrand_x; /* The state can be seeded with any value. */
+
+// the state of wyrand is a single 64-bit word
+static inline void wyrand_seed_r(uint64_t *state, uint64_t seed) {
+  *state = seed;
+}
 
 // call wyrand_seed before calling wyrand
-static inline void wyrand_seed(uint64_t seed) { wyrand_x = seed; }
+static inline void wyrand_seed(uint64_t seed) { wyrand_seed_r(&wyrand_x, seed); }
 
 static inline uint64_t wyrand_stateless(uint64_t *s) {
   *s += UINT64_C(0xa0761d6478bd642f);
@@ -13,9 +24,43 @@ static inline uint64_t wyrand_stateless(uint64_t *s) {
   return (t >> 64) ^ t;
 }
 
+// returns random number, modifies *state
+static inline uint64_t wyrand_r(uint64_t *state) { return wyrand_stateless(state); }
+
 // returns random number, modifies wyrand_x
-static inline uint64_t wyrand(void) { return wyrand_stateless(&wyrand_x); }
+static inline uint64_t wyrand(void) { return wyrand_r(&wyrand_x); }
+
+// writes the next n values of wyrand, the same ones that n calls to
+// wyrand_r(state) would return; each value only depends on its position in
+// the Weyl sequence, so we compute several at once
+static inline void wyrand_fill_r(uint64_t *state, uint64_t *out, size_t n) {
+  size_t i = 0;
+#if defined(SIMD64_FAST_MULFULL)
+  const simd64_t step = simd64_set1(SIMD64_LANES * UINT64_C(0xa0761d6478bd642f));
+  const simd64_t k = simd64_set1(UINT64_C(0xe7037ed1a0b428db));
+  simd64_t weyl = simd64_weyl(*state, UINT64_C(0xa0761d6478bd642f));
+  const size_t vectors = n - n % SIMD64_LANES;
+  for (; i < vectors; i += SIMD64_LANES) {
+    simd64_t s = weyl;
+    weyl = simd64_add(weyl, step);
+    simd64_t hi;
+    simd64_t lo = simd64_mulfull(s, simd64_xor(s, k), &hi);
+    simd64_storeu(out + i, simd64_xor(hi, lo));
+  }
+  *state += i * UINT64_C(0xa0761d6478bd642f);
+#endif
+  for (; i < n; i++) {
+    out[i] = wyrand_stateless(state);
+  }
+}
+
+// writes the next n values of wyrand, modifies wyrand_x
+static inline void wyrand_fill(uint64_t *out, size_t n) {
+  wyrand_fill_r(&wyrand_x, out, n);
+}
 
 // returns the 32 least significant bits of a call to wyrand
 // this is a simple function call followed by a cast
 static inline uint32_t wyrand_cast32(void) { return (uint32_t)wyrand(); }
+
+#endif // WYRAND_H
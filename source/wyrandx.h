@@ -0,0 +1,126 @@
+#ifndef WYRANDX_H
+#define WYRANDX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "splitmix64.h"
+#include "wyrand.h"
+
+// Interleaved wyrand: 2, 4 or 8 separately seeded wyrand generators advance
+// in lockstep, as lehmer64x.h does for lehmer64. The resulting stream
+// interleaves the lanes (out[0] is lane 0, out[1] is lane 1, ...) and every
+// lane is exactly wyrand_r on its own state. Unlike lehmer64, wyrand only
+// carries an addition from one step to the next, so a single stream
+// already overlaps its multiplications: expect a smaller gain.
+
+#define WYRANDX_MAX_LANES 8
+
+// number of lanes of the global generator (2, 4 or 8)
+#ifndef WYRANDX_LANES
+#define WYRANDX_LANES 4
+#endif
+
+typedef struct {
+  uint64_t s[WYRANDX_MAX_LANES];
+  // outputs not yet handed out by wyrandx_r
+  uint64_t buffer[WYRANDX_MAX_LANES];
+  size_t offset;
+  size_t lanes;
+} wyrandx_state;
+
+static wyrandx_state g_wyrandx_state;
+
+// Each lane is seeded on its own, from splitmix64 of (seed, lane). Lanes
+// a power of two apart along the Weyl sequence (i * 2^61 steps) would
+// differ only in their top bits, and the mix of wyrand does not hide that.
+static inline void wyrandx_seed_r(wyrandx_state *state, uint64_t seed,
+                                  size_t lanes) {
+  state->lanes = (lanes == 2 || lanes == 4) ? lanes : WYRANDX_MAX_LANES;
+  for (size_t i = 0; i < state->lanes; i++) {
+    wyrand_seed_r(&state->s[i], splitmix64_stateless(seed, i));
+  }
+  state->offset = state->lanes;
+}
+
+// advances every lane once, writes one output per lane
+static inline __attribute__((always_inline)) void
+wyrandx_step_r(wyrandx_state *state, uint64_t *out, size_t lanes) {
+  for (size_t j = 0; j < lanes; j++) {
+    out[j] = wyrand_r(&state->s[j]);
+  }
+}
+
+static inline void wyrandx_refill_r(wyrandx_state *state) {
+  switch (state->lanes) {
+  case 2:
+    wyrandx_step_r(state, state->buffer, 2);
+    break;
+  case 4:
+    wyrandx_step_r(state, state->buffer, 4);
+    break;
+  default:
+    wyrandx_step_r(state, state->buffer, 8);
+    break;
+  }
+  state->offset = 0;
+}
+
+// returns random number, one lane at a time
+static inline uint64_t wyrandx_r(wyrandx_state *state) {
+  if (__builtin_expect(state->offset >= state->lanes, 0)) {
+    wyrandx_refill_r(state);
+  }
+  return state->buffer[state->offset++];
+}
+
+// writes whole steps straight to out; the state copy lives in registers
+static inline __attribute__((always_inline)) size_t
+wyrandx_fill_lanes_r(wyrandx_state *state, uint64_t *out, size_t n,
+                     size_t lanes) {
+  wyrandx_state copy = *state;
+  size_t i = 0;
+  for (; i + lanes <= n; i += lanes) {
+    wyrandx_step_r(&copy, out + i, lanes);
+  }
+  for (size_t j = 0; j < lanes; j++) state->s[j] = copy.s[j];
+  return i;
+}
+
+// writes the next n values of the stream, the same ones that n calls to
+// wyrandx_r would have returned
+static inline void wyrandx_fill_r(wyrandx_state *state, uint64_t *out,
+                                  size_t n) {
+  size_t i = 0;
+  while (i < n && state->offset < state->lanes) {
+    out[i++] = state->buffer[state->offset++];
+  }
+  switch (state->lanes) {
+  case 2:
+    i += wyrandx_fill_lanes_r(state, out + i, n - i, 2);
+    break;
+  case 4:
+    i += wyrandx_fill_lanes_r(state, out + i, n - i, 4);
+    break;
+  default:
+    i += wyrandx_fill_lanes_r(state, out + i, n - i, 8);
+    break;
+  }
+  for (; i < n; i++) {
+    out[i] = wyrandx_r(state);
+  }
+}
+
+static inline void wyrandx_seed(uint64_t seed) {
+  wyrandx_seed_r(&g_wyrandx_state, seed, WYRANDX_LANES);
+}
+
+static inline uint64_t wyrandx(void) {
+  return wyrandx_r(&g_wyrandx_state);
+}
+
+static inline void wyrandx_fill(uint64_t *out, size_t n) {
+  wyrandx_fill_r(&g_wyrandx_state, out, n);
+}
+
+#endif // WYRANDX_H
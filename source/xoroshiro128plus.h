@@ -3,7 +3,9 @@
 
 /* Modified by D. Lemire, August 2017 */
 #include "splitmix64.h"
+#include <stddef.h>
 #include <stdint.h>
+#include "fill.h"
 
 // original documentation by Vigna:
 /* This is the successor to xorshift128+. It is the fastest full-period
@@ -26,29 +28,103 @@
    output to fill s. */
 
 // state for xoroshiro128plus
-uint64_t xoroshiro128plus_s[2];
+typedef struct {
+  uint64_t s[2];
+} xoroshiro128plus_state;
+
+static xoroshiro128plus_state g_xoroshiro128plus_state;
 
 static inline uint64_t rotl(const uint64_t x, int k) {
   return (x << k) | (x >> (64 - k));
 }
 
-// call this one before calling xoroshiro128plus
-static inline void xoroshiro128plus_seed(uint64_t seed) {
-  xoroshiro128plus_s[0] = splitmix64_r(&seed);
-  xoroshiro128plus_s[1] = splitmix64_r(&seed);
+static inline void xoroshiro128plus_seed_r(xoroshiro128plus_state *state,
+                                           uint64_t seed) {
+  state->s[0] = splitmix64_r(&seed);
+  state->s[1] = splitmix64_r(&seed);
 }
 
-// returns random number, modifies xoroshiro128plus_s
-static inline uint64_t xoroshiro128plus(void) {
-  const uint64_t s0 = xoroshiro128plus_s[0];
-  uint64_t s1 = xoroshiro128plus_s[1];
+// returns random number, modifies state->s
+static inline uint64_t xoroshiro128plus_r(xoroshiro128plus_state *state) {
+  const uint64_t s0 = state->s[0];
+  uint64_t s1 = state->s[1];
   const uint64_t result = s0 + s1;
 
   s1 ^= s0;
-  xoroshiro128plus_s[0] = rotl(s0, 55) ^ s1 ^ (s1 << 14); // a, b
-  xoroshiro128plus_s[1] = rotl(s1, 36);                   // c
+  state->s[0] = rotl(s0, 55) ^ s1 ^ (s1 << 14); // a, b
+  state->s[1] = rotl(s1, 36);                   // c
 
   return result;
 }
 
+// Jump polynomials: the coefficients of x^(2^64) and x^(2^96) modulo the
+// characteristic polynomial of the xoroshiro128plus transition (the first one
+// is Vigna's JUMP table for these shift constants).
+static const uint64_t xoroshiro128plus_jump_poly[2] = {
+    UINT64_C(0xbeac0467eba5facb), UINT64_C(0xd86b048b86aa9922)};
+static const uint64_t xoroshiro128plus_long_jump_poly[2] = {
+    UINT64_C(0x18f7c399ccebda8d), UINT64_C(0xf2deac28bef3bb07)};
+
+// advances the state by the number of steps encoded in poly
+static inline void xoroshiro128plus_jump_with(xoroshiro128plus_state *state,
+                                              const uint64_t poly[2]) {
+  uint64_t s0 = 0;
+  uint64_t s1 = 0;
+  for (int i = 0; i < 2; i++) {
+    for (int b = 0; b < 64; b++) {
+      if (poly[i] & (UINT64_C(1) << b)) {
+        s0 ^= state->s[0];
+        s1 ^= state->s[1];
+      }
+      xoroshiro128plus_r(state);
+    }
+  }
+  state->s[0] = s0;
+  state->s[1] = s1;
+}
+
+// equivalent to 2^64 calls to xoroshiro128plus_r
+static inline void xoroshiro128plus_jump_r(xoroshiro128plus_state *state) {
+  xoroshiro128plus_jump_with(state, xoroshiro128plus_jump_poly);
+}
+
+// equivalent to 2^96 calls to xoroshiro128plus_r
+static inline void xoroshiro128plus_long_jump_r(xoroshiro128plus_state *state) {
+  xoroshiro128plus_jump_with(state, xoroshiro128plus_long_jump_poly);
+}
+
+// writes n states whose streams do not overlap for 2^64 values each:
+// out[0] is *state and out[i] is out[i - 1] after a jump
+static inline void xoroshiro128plus_split_r(const xoroshiro128plus_state *state,
+                                            xoroshiro128plus_state *out,
+                                            size_t n) {
+  if (n == 0) return;
+  out[0] = *state;
+  for (size_t i = 1; i < n; i++) {
+    out[i] = out[i - 1];
+    xoroshiro128plus_jump_r(&out[i]);
+  }
+}
+
+// call this one before calling xoroshiro128plus
+static inline void xoroshiro128plus_seed(uint64_t seed) {
+  xoroshiro128plus_seed_r(&g_xoroshiro128plus_state, seed);
+}
+
+// returns random number, modifies the global state
+static inline uint64_t xoroshiro128plus(void) {
+  return xoroshiro128plus_r(&g_xoroshiro128plus_state);
+}
+
+static inline void xoroshiro128plus_jump(void) {
+  xoroshiro128plus_jump_r(&g_xoroshiro128plus_state);
+}
+
+static inline void xoroshiro128plus_long_jump(void) {
+  xoroshiro128plus_long_jump_r(&g_xoroshiro128plus_state);
+}
+
+FILL_GENERIC(xoroshiro128plus, xoroshiro128plus_state, uint64_t,
+             g_xoroshiro128plus_state)
+
 #endif // XOROSHIRO128PLUS_H
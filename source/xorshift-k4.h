@@ -7,23 +7,38 @@
  * Journal of Statistical Software. Vol. 8 (Issue  14). */
 
 #include "splitmix64.h"
+#include "fill.h"
 
-static uint32_t xorshift_k4_x, xorshift_k4_y, xorshift_k4_z, xorshift_k4_w;
+typedef struct {
+  uint32_t x, y, z, w;
+} xorshift_k4_state;
 
-static inline void xorshift_k4_seed(uint64_t seed) {
-  xorshift_k4_x = splitmix64_r(&seed);
-  xorshift_k4_y = splitmix64_r(&seed);
-  xorshift_k4_z = splitmix64_r(&seed);
-  xorshift_k4_w = splitmix64_r(&seed);
+static xorshift_k4_state g_xorshift_k4_state;
+
+static inline void xorshift_k4_seed_r(xorshift_k4_state *state, uint64_t seed) {
+  state->x = splitmix64_r(&seed);
+  state->y = splitmix64_r(&seed);
+  state->z = splitmix64_r(&seed);
+  state->w = splitmix64_r(&seed);
   return;
 }
 
+static inline uint32_t xorshift_k4_r(xorshift_k4_state *state) {
+  uint32_t t = state->x ^ (state->x << 11);
+  state->x = state->y;
+  state->y = state->z;
+  state->z = state->w;
+  return state->w = state->w ^ (state->w >> 19) ^ (t ^ (t >> 8));
+}
+
+static inline void xorshift_k4_seed(uint64_t seed) {
+  xorshift_k4_seed_r(&g_xorshift_k4_state, seed);
+}
+
 static inline uint32_t xorshift_k4(void) {
-  uint32_t t = xorshift_k4_x ^ (xorshift_k4_x << 11);
-  xorshift_k4_x = xorshift_k4_y;
-  xorshift_k4_y = xorshift_k4_z;
-  xorshift_k4_z = xorshift_k4_w;
-  return xorshift_k4_w = xorshift_k4_w ^ (xorshift_k4_w >> 19) ^ (t ^ (t >> 8));
+  return xorshift_k4_r(&g_xorshift_k4_state);
 }
 
+FILL_GENERIC(xorshift_k4, xorshift_k4_state, uint32_t, g_xorshift_k4_state)
+
 #endif
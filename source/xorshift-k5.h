@@ -7,27 +7,41 @@
    https://groups.google.com/d/msg/comp.lang.c/qZFQgKRCQGg/rmPkaRHqxOMJ */
 
 #include "splitmix64.h"
+#include "fill.h"
 
-static uint32_t xorshift_k5_x, xorshift_k5_y, xorshift_k5_z, xorshift_k5_w,
-    xorshift_k5_v;
+typedef struct {
+  uint32_t x, y, z, w, v;
+} xorshift_k5_state;
 
-static inline void xorshift_k5_seed(uint64_t seed) {
-  xorshift_k5_x = splitmix64_r(&seed);
-  xorshift_k5_y = splitmix64_r(&seed);
-  xorshift_k5_z = splitmix64_r(&seed);
-  xorshift_k5_w = splitmix64_r(&seed);
-  xorshift_k5_v = splitmix64_r(&seed);
+static xorshift_k5_state g_xorshift_k5_state;
+
+static inline void xorshift_k5_seed_r(xorshift_k5_state *state, uint64_t seed) {
+  state->x = splitmix64_r(&seed);
+  state->y = splitmix64_r(&seed);
+  state->z = splitmix64_r(&seed);
+  state->w = splitmix64_r(&seed);
+  state->v = splitmix64_r(&seed);
   return;
 }
 
+static inline uint32_t xorshift_k5_r(xorshift_k5_state *state) {
+  uint32_t t = (state->x ^ (state->x >> 7));
+  state->x = state->y;
+  state->y = state->z;
+  state->z = state->w;
+  state->w = state->v;
+  state->v = (state->v ^ (state->v << 6)) ^ (t ^ (t << 13));
+  return (state->y + state->y + 1) * state->v;
+}
+
+static inline void xorshift_k5_seed(uint64_t seed) {
+  xorshift_k5_seed_r(&g_xorshift_k5_state, seed);
+}
+
 static inline uint32_t xorshift_k5(void) {
-  uint32_t t = (xorshift_k5_x ^ (xorshift_k5_x >> 7));
-  xorshift_k5_x = xorshift_k5_y;
-  xorshift_k5_y = xorshift_k5_z;
-  xorshift_k5_z = xorshift_k5_w;
-  xorshift_k5_w = xorshift_k5_v;
-  xorshift_k5_v = (xorshift_k5_v ^ (xorshift_k5_v << 6)) ^ (t ^ (t << 13));
-  return (xorshift_k5_y + xorshift_k5_y + 1) * xorshift_k5_v;
+  return xorshift_k5_r(&g_xorshift_k5_state);
 }
 
+FILL_GENERIC(xorshift_k5, xorshift_k5_state, uint32_t, g_xorshift_k5_state)
+
 #endif
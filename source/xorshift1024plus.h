@@ -3,31 +3,49 @@
 
 #include "splitmix64.h"
 #include <stdint.h>
+#include "fill.h"
 
 /* Figure 2 in Further scramblings of Marsaglia’s xorshift generators
  by Vigna.
  */
 
 #define xorshift1024plus_size 16
-static uint64_t xorshift1024plus_s[xorshift1024plus_size];
-static int xorshift1024plus_p;
 
-// call once before calling xorshift1024plus
-static inline void xorshift1024plus_seed(uint64_t seed) {
-  xorshift1024plus_p = 0;
+typedef struct {
+  uint64_t s[xorshift1024plus_size];
+  int p;
+} xorshift1024plus_state;
+
+static xorshift1024plus_state g_xorshift1024plus_state;
+
+static inline void xorshift1024plus_seed_r(xorshift1024plus_state *state,
+                                           uint64_t seed) {
+  state->p = 0;
   for (int k = 0; k < xorshift1024plus_size; k++)
-    xorshift1024plus_s[k] = splitmix64_r(&seed);
+    state->s[k] = splitmix64_r(&seed);
 }
-// returns random number, modifies xorshift1024plus_s and xorshift1024plus_p
-static inline uint64_t xorshift1024plus(void) {
-  const uint64_t s0 = xorshift1024plus_s[xorshift1024plus_p];
-  uint64_t s1 =
-      xorshift1024plus_s[xorshift1024plus_p = (xorshift1024plus_p + 1) & 15];
+
+// returns random number, modifies state->s and state->p
+static inline uint64_t xorshift1024plus_r(xorshift1024plus_state *state) {
+  const uint64_t s0 = state->s[state->p];
+  uint64_t s1 = state->s[state->p = (state->p + 1) & 15];
   const uint64_t result = s0 + s1;
   s1 ^= s1 << 31; // a
-  xorshift1024plus_s[xorshift1024plus_p] =
-      s1 ^ s0 ^ (s1 >> 11) ^ (s0 >> 30); // b, c
+  state->s[state->p] = s1 ^ s0 ^ (s1 >> 11) ^ (s0 >> 30); // b, c
   return result;
 }
 
+// call once before calling xorshift1024plus
+static inline void xorshift1024plus_seed(uint64_t seed) {
+  xorshift1024plus_seed_r(&g_xorshift1024plus_state, seed);
+}
+
+// returns random number, modifies the global state
+static inline uint64_t xorshift1024plus(void) {
+  return xorshift1024plus_r(&g_xorshift1024plus_state);
+}
+
+FILL_GENERIC(xorshift1024plus, xorshift1024plus_state, uint64_t,
+             g_xorshift1024plus_state)
+
 #endif // XORSHIFT1024PLUS_H
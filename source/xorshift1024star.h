@@ -3,7 +3,9 @@
 
 /* Modified by D. Lemire, August 2017 */
 #include "splitmix64.h"
+#include <stddef.h>
 #include <stdint.h>
+#include "fill.h"
 
 /*  Written in 2014 by Sebastiano Vigna (vigna@acm.org)
 
@@ -25,25 +27,87 @@ See <http://creativecommons.org/publicdomain/zero/1.0/>. */
    output to fill s. */
 
 #define xorshift1024star_size 16
-static uint64_t xorshift1024star_s[xorshift1024star_size];
-static int xorshift1024star_p;
+
+typedef struct {
+  uint64_t s[xorshift1024star_size];
+  int p;
+} xorshift1024star_state;
+
+static xorshift1024star_state g_xorshift1024star_state;
+
+static inline void xorshift1024star_seed_r(xorshift1024star_state *state,
+                                           uint64_t seed) {
+  state->p = 0;
+  for (int k = 0; k < xorshift1024star_size; k++)
+    state->s[k] = splitmix64_r(&seed);
+}
+
+// returns random number, modifies state->s and state->p
+static inline uint64_t xorshift1024star_r(xorshift1024star_state *state) {
+  const uint64_t s0 = state->s[state->p];
+  state->p = (state->p + 1) % xorshift1024star_size;
+  uint64_t s1 = state->s[state->p];
+  s1 ^= s1 << 31; // a
+  state->s[state->p] = s1 ^ s0 ^ (s1 >> 11) ^ (s0 >> 30); // b,c
+  return state->s[state->p] * UINT64_C(1181783497276652981);
+}
+
+// Jump polynomial: the coefficients of x^(2^512) modulo the characteristic
+// polynomial of the xorshift1024star transition (Vigna's JUMP table).
+static const uint64_t xorshift1024star_jump_poly[xorshift1024star_size] = {
+    UINT64_C(0x84242f96eca9c41d), UINT64_C(0xa3c65b8776f96855),
+    UINT64_C(0x5b34a39f070b5837), UINT64_C(0x4489affce4f31a1e),
+    UINT64_C(0x2ffeeb0a48316f40), UINT64_C(0xdc2d9891fe68c022),
+    UINT64_C(0x3659132bb12fea70), UINT64_C(0xaac17d8efa43cab8),
+    UINT64_C(0xc4cb815590989b13), UINT64_C(0x5ee975283d71c93b),
+    UINT64_C(0x691548c86c1bd540), UINT64_C(0x7910c41d10a1e6a5),
+    UINT64_C(0x0b5fc64563b3e2a8), UINT64_C(0x047f7684e9fc949d),
+    UINT64_C(0xb99181f2d8f685ca), UINT64_C(0x284600e3f30e38c3)};
+
+// equivalent to 2^512 calls to xorshift1024star_r
+static inline void xorshift1024star_jump_r(xorshift1024star_state *state) {
+  uint64_t t[xorshift1024star_size] = {0};
+  for (int i = 0; i < xorshift1024star_size; i++) {
+    for (int b = 0; b < 64; b++) {
+      if (xorshift1024star_jump_poly[i] & (UINT64_C(1) << b)) {
+        for (int j = 0; j < xorshift1024star_size; j++)
+          t[j] ^= state->s[(j + state->p) % xorshift1024star_size];
+      }
+      xorshift1024star_r(state);
+    }
+  }
+  for (int j = 0; j < xorshift1024star_size; j++)
+    state->s[(j + state->p) % xorshift1024star_size] = t[j];
+}
+
+// writes n states whose streams do not overlap for 2^512 values each:
+// out[0] is *state and out[i] is out[i - 1] after a jump
+static inline void xorshift1024star_split_r(const xorshift1024star_state *state,
+                                            xorshift1024star_state *out,
+                                            size_t n) {
+  if (n == 0) return;
+  out[0] = *state;
+  for (size_t i = 1; i < n; i++) {
+    out[i] = out[i - 1];
+    xorshift1024star_jump_r(&out[i]);
+  }
+}
 
 // call once before calling xorshift1024star
 static inline void xorshift1024star_seed(uint64_t seed) {
-  xorshift1024star_p = 0;
-  for (int k = 0; k < xorshift1024star_size; k++)
-    xorshift1024star_s[k] = splitmix64_r(&seed);
+  xorshift1024star_seed_r(&g_xorshift1024star_state, seed);
 }
 
-// returns random number, modifies xorshift1024star_s and xorshift1024star_p
+// returns random number, modifies the global state
 static inline uint64_t xorshift1024star(void) {
-  const uint64_t s0 = xorshift1024star_s[xorshift1024star_p];
-  xorshift1024star_p = (xorshift1024star_p + 1) % xorshift1024star_size;
-  uint64_t s1 = xorshift1024star_s[xorshift1024star_p];
-  s1 ^= s1 << 31; // a
-  xorshift1024star_s[xorshift1024star_p] =
-      s1 ^ s0 ^ (s1 >> 11) ^ (s0 >> 30); // b,c
-  return xorshift1024star_s[xorshift1024star_p] * UINT64_C(1181783497276652981);
+  return xorshift1024star_r(&g_xorshift1024star_state);
+}
+
+static inline void xorshift1024star_jump(void) {
+  xorshift1024star_jump_r(&g_xorshift1024star_state);
 }
 
+FILL_GENERIC(xorshift1024star, xorshift1024star_state, uint64_t,
+             g_xorshift1024star_state)
+
 #endif // XORSHIFT1024STAR_H
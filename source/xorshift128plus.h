@@ -1,9 +1,11 @@
 #ifndef XORSHIFT128PLUS_H
 #define XORSHIFT128PLUS_H
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include "splitmix64.h"
+#include "fill.h"
 
 /* Keys for scalar xorshift128. Must be non-zero
 These are modified by xorshift128plus.
@@ -23,10 +25,20 @@ static inline void xorshift128plus_init(uint64_t key1, uint64_t key2,
   key->part2 = key2;
 }
 
-static inline void xorshift128plus_seed(uint64_t seed) {
+// xorshift128plus and v8xorshift128plus share the same state and seeding
+static inline void xorshift128plus_seed_r(xorshift128plus_key_t *key,
+                                          uint64_t seed) {
   xorshift128plus_init(splitmix64_stateless(seed, 0),
-                       splitmix64_stateless(seed, 1),
-                       &global_xorshift128plus_key);
+                       splitmix64_stateless(seed, 1), key);
+}
+
+static inline void v8xorshift128plus_seed_r(xorshift128plus_key_t *key,
+                                            uint64_t seed) {
+  xorshift128plus_seed_r(key, seed);
+}
+
+static inline void xorshift128plus_seed(uint64_t seed) {
+  xorshift128plus_seed_r(&global_xorshift128plus_key, seed);
 }
 
 // this is the code as found on Vigna's site
@@ -62,7 +74,7 @@ static inline void xorshift128plus_seed(uint64_t seed) {
    internal parallelization from the CPU. The resulting streams are off by
    one step. */
 
-uint64_t xorshift128plus_r(xorshift128plus_key_t *key) {
+static inline uint64_t xorshift128plus_r(xorshift128plus_key_t *key) {
   uint64_t s1 = key->part1;
   const uint64_t s0 = key->part2;
   key->part1 = s0;
@@ -75,7 +87,7 @@ uint64_t xorshift128plus_r(xorshift128plus_key_t *key) {
 // https://en.wikipedia.org/wiki/Xorshift#xorshift.2B (Oct 4th 2018)
 // as well as the version reported to be used by the v8 project
 // https://v8project.blogspot.ca/2015/12/theres-mathrandom-and-then-theres.html
-uint64_t v8xorshift128plus_r(xorshift128plus_key_t *key) {
+static inline uint64_t v8xorshift128plus_r(xorshift128plus_key_t *key) {
   uint64_t s1 = key->part1;
   const uint64_t s0 = key->part2;
   key->part1 = s0;
@@ -84,6 +96,64 @@ uint64_t v8xorshift128plus_r(xorshift128plus_key_t *key) {
   return key->part2 + s0;
 }
 
+// Jump polynomials: the coefficients of x^(2^64) and x^(2^96) modulo the
+// characteristic polynomial of the xorshift128plus transition (the first one
+// is Vigna's JUMP table). They do not apply to v8xorshift128plus, whose
+// shift constants differ.
+static const uint64_t xorshift128plus_jump_poly[2] = {
+    UINT64_C(0x8a5cd789635d2dff), UINT64_C(0x121fd2155c472f96)};
+static const uint64_t xorshift128plus_long_jump_poly[2] = {
+    UINT64_C(0xea61c9f1f13962ae), UINT64_C(0xa1fe50ef79cfafb2)};
+
+// advances the key by the number of steps encoded in poly
+static inline void xorshift128plus_jump_with(xorshift128plus_key_t *key,
+                                             const uint64_t poly[2]) {
+  uint64_t s0 = 0;
+  uint64_t s1 = 0;
+  for (int i = 0; i < 2; i++) {
+    for (int b = 0; b < 64; b++) {
+      if (poly[i] & (UINT64_C(1) << b)) {
+        s0 ^= key->part1;
+        s1 ^= key->part2;
+      }
+      xorshift128plus_r(key);
+    }
+  }
+  key->part1 = s0;
+  key->part2 = s1;
+}
+
+// equivalent to 2^64 calls to xorshift128plus_r
+static inline void xorshift128plus_jump_r(xorshift128plus_key_t *key) {
+  xorshift128plus_jump_with(key, xorshift128plus_jump_poly);
+}
+
+// equivalent to 2^96 calls to xorshift128plus_r
+static inline void xorshift128plus_long_jump_r(xorshift128plus_key_t *key) {
+  xorshift128plus_jump_with(key, xorshift128plus_long_jump_poly);
+}
+
+// writes n keys whose streams do not overlap for 2^64 values each:
+// out[0] is *key and out[i] is out[i - 1] after a jump
+static inline void xorshift128plus_split_r(const xorshift128plus_key_t *key,
+                                           xorshift128plus_key_t *out,
+                                           size_t n) {
+  if (n == 0) return;
+  out[0] = *key;
+  for (size_t i = 1; i < n; i++) {
+    out[i] = out[i - 1];
+    xorshift128plus_jump_r(&out[i]);
+  }
+}
+
+static inline void xorshift128plus_jump() {
+  xorshift128plus_jump_r(&global_xorshift128plus_key);
+}
+
+static inline void xorshift128plus_long_jump() {
+  xorshift128plus_long_jump_r(&global_xorshift128plus_key);
+}
+
 static inline uint64_t xorshift128plus() {
   return xorshift128plus_r(&global_xorshift128plus_key);
 }
@@ -92,4 +162,9 @@ static inline uint64_t v8xorshift128plus() {
   return v8xorshift128plus_r(&global_xorshift128plus_key);
 }
 
+FILL_GENERIC(xorshift128plus, xorshift128plus_key_t, uint64_t,
+             global_xorshift128plus_key)
+FILL_GENERIC(v8xorshift128plus, xorshift128plus_key_t, uint64_t,
+             global_xorshift128plus_key)
+
 #endif
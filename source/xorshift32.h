@@ -3,15 +3,25 @@
 
 #include "splitmix64.h"
 #include <stdint.h>
+#include "fill.h"
 
 static unsigned int xorshift_y;
 
-void xorshift32_seed(uint64_t seed) { xorshift_y = seed; }
+// the state of xorshift32 is a single 32-bit word
+static inline void xorshift32_seed_r(unsigned int *state, uint64_t seed) {
+  *state = seed;
+}
 
-unsigned int xorshift32(void) {
-  xorshift_y ^= (xorshift_y << 13);
-  xorshift_y ^= (xorshift_y >> 17);
-  return xorshift_y ^= (xorshift_y << 5);
+static inline unsigned int xorshift32_r(unsigned int *state) {
+  *state ^= (*state << 13);
+  *state ^= (*state >> 17);
+  return *state ^= (*state << 5);
 }
 
+static inline void xorshift32_seed(uint64_t seed) { xorshift32_seed_r(&xorshift_y, seed); }
+
+static inline unsigned int xorshift32(void) { return xorshift32_r(&xorshift_y); }
+
+FILL_GENERIC(xorshift32, unsigned int, uint32_t, xorshift_y)
+
 #endif // XORSHIFT32_H
@@ -0,0 +1,150 @@
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <span>
+#include <string_view>
+#include <vector>
+#include <format>
+#include <iostream>
+
+#include "counters/bench.h"
+
+#include "engines.hpp"
+
+// Time per value of the standard <random> distributions over each engine of
+// engines.hpp. The first two columns are the engine alone (operator() in a
+// loop, then generate); the others give the whole cost of a distributed
+// value, engine included. With a 32-bit engine, the 64-bit distributions
+// need two calls per value.
+
+size_t count = 4096;
+
+// fastest time per value, in ns
+double per_value(counters::event_aggregate agg) {
+  return agg.fastest_elapsed_ns() / double(count);
+}
+
+template <typename Engine, typename Distribution>
+double time_distribution(Engine &engine, Distribution distribution,
+                         std::vector<double> &out) {
+  return per_value(counters::bench([&]() {
+    for (double &x : out) x = double(distribution(engine));
+  }));
+}
+
+const char *columns[] = {"call", "generate", "int[0,1000)", "uint64",
+                         "canonical", "uniform", "normal", "exponential",
+                         "bernoulli"};
+
+template <typename Engine> void bench_engine(const char *name) {
+  using T = typename Engine::result_type;
+  Engine engine;
+  std::vector<T> raw(count);
+  std::vector<double> out(count);
+  std::vector<double> ns;
+  ns.push_back(per_value(counters::bench([&]() {
+    for (T &x : raw) x = engine();
+  })));
+  if constexpr (requires { engine.generate(std::span<T>(raw)); }) {
+    ns.push_back(per_value(counters::bench([&]() {
+      engine.generate(std::span<T>(raw));
+    })));
+  } else {
+    ns.push_back(-1); // the standard engines have no bulk generate
+  }
+  ns.push_back(time_distribution(
+      engine, std::uniform_int_distribution<uint32_t>(0, 999), out));
+  ns.push_back(
+      time_distribution(engine, std::uniform_int_distribution<uint64_t>(), out));
+  ns.push_back(per_value(counters::bench([&]() {
+    for (double &x : out) {
+      x = std::generate_canonical<double, std::numeric_limits<double>::digits>(
+          engine);
+    }
+  })));
+  ns.push_back(time_distribution(
+      engine, std::uniform_real_distribution<double>(0, 1), out));
+  ns.push_back(
+      time_distribution(engine, std::normal_distribution<double>(), out));
+  ns.push_back(
+      time_distribution(engine, std::exponential_distribution<double>(), out));
+  ns.push_back(time_distribution(engine, std::bernoulli_distribution(0.5), out));
+  std::cout << std::format("{:<24} :", name);
+  for (double v : ns) {
+    if (v < 0) {
+      std::cout << std::format(" {:>11}", "-");
+    } else {
+      std::cout << std::format(" {:>11.2f}", v);
+    }
+  }
+  std::cout << "\n";
+}
+
+int main(int argc, char **argv) {
+  for (int i = 1; i < argc; i++) {
+    std::string_view arg(argv[i]);
+    if (arg == "--count" && i + 1 < argc) {
+      count = size_t(strtoull(argv[++i], nullptr, 10));
+    } else {
+      std::cout << std::format("Usage: {} [--count N]\n", argv[0]);
+      std::cout << "Times N values (4096 by default) of each <random> distribution over each engine.\n";
+      return strcmp(argv[i], "--help") == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  }
+  if (count == 0) count = 1;
+  std::cout << std::format("Drawing {} values; time reported in ns per value.\n\n", count);
+  std::cout << std::format("{:<24} :", "engine");
+  for (const char *column : columns) std::cout << std::format(" {:>11}", column);
+  std::cout << "\n";
+
+  using namespace testingrng;
+  bench_engine<std::mt19937>("std::mt19937");
+  bench_engine<std::mt19937_64>("std::mt19937_64");
+  bench_engine<trivium32_engine>("trivium");
+  bench_engine<xorshift_k4_engine>("xorshift_k4");
+  bench_engine<xorshift_k5_engine>("xorshift_k5");
+  bench_engine<mersennetwister_engine>("mersennetwister");
+  bench_engine<mitchellmoore_engine>("mitchellmoore");
+  bench_engine<widynski_engine>("widynski");
+  bench_engine<xorshift32_engine>("xorshift32");
+  bench_engine<pcg32_engine>("pcg32");
+  bench_engine<trivium64_engine>("trivium64");
+#ifdef __AES__
+  bench_engine<aesdragontamer_engine>("aesdragontamer");
+  bench_engine<aesctr_engine>("aesctr");
+#ifdef AESCTR_VAES_LANES
+  bench_engine<aesctr_vaes_engine>("aesctr_vaes");
+#endif
+#ifdef AESDRAGONTAMER_VAES_LANES
+  bench_engine<aesdragontamer_vaes_engine>("aesdragontamer_vaes");
+#endif
+#endif
+  bench_engine<lehmer64_engine>("lehmer64");
+  bench_engine<lehmer64x_engine>("lehmer64x");
+  bench_engine<xorshift128plus_engine>("xorshift128plus");
+  bench_engine<v8xorshift128plus_engine>("v8xorshift128plus");
+  bench_engine<xoroshiro128plus_engine>("xoroshiro128plus");
+#ifdef __AVX2__
+  bench_engine<simdxorshift128plus_engine>("simdxorshift128plus");
+  bench_engine<simdxoroshiro128plus_engine>("simdxoroshiro128plus");
+  bench_engine<simdtrivium64_engine>("simdtrivium64");
+#endif
+  bench_engine<splitmix64_engine>("splitmix64");
+  bench_engine<splitmix63_engine>("splitmix63");
+  bench_engine<pcg64_engine>("pcg64");
+  bench_engine<xorshift1024star_engine>("xorshift1024star");
+  bench_engine<xorshift1024plus_engine>("xorshift1024plus");
+  bench_engine<wyhash64_engine>("wyhash64");
+  bench_engine<wyrand_engine>("wyrand");
+  bench_engine<wyrandx_engine>("wyrandx");
+  bench_engine<w1rand_engine>("w1rand");
+  bench_engine<jenkinssmall_engine>("jenkinssmall");
+  bench_engine<philox4x32_engine>("philox4x32");
+  bench_engine<philox4x64_engine>("philox4x64");
+  bench_engine<threefry2x64_engine>("threefry2x64");
+  bench_engine<threefry4x64_engine>("threefry4x64");
+  bench_engine<CG64_engine>("CG64");
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,38 @@
+// Compiled once per kernel variant, with RNG_VARIANT set to its name and
+// the compiler flags of its instruction-set level: see generators.h.
+#include <cstdlib>
+
+#include "generators.h"
+
+#include "registry.h"
+
+#ifndef RNG_VARIANT
+#define RNG_VARIANT baseline
+#endif
+
+// everything below has internal linkage, so each variant keeps its own copy
+namespace {
+
+void rand_seed(void *, uint64_t seed) { srand((unsigned)seed); }
+uint32_t rand_next(void *) { return (uint32_t)rand(); }
+void rand_fill(void *, void *out, size_t n) {
+  for (size_t i = 0; i < n; i++) ((uint32_t *)out)[i] = (uint32_t)rand();
+}
+
+const rng_info extras[] = {
+    {"rand", "rand", 32, 1, rand_seed, {.next32 = rand_next}, rand_fill,
+     rand_fill, 0, nullptr, 0},
+};
+
+} // namespace
+
+#define RNG_CONCAT_(a, b) a##b
+#define RNG_CONCAT(a, b) RNG_CONCAT_(a, b)
+#define RNG_STRING_(a) #a
+#define RNG_STRING(a) RNG_STRING_(a)
+
+generator_set RNG_CONCAT(generators_, RNG_VARIANT)() {
+  return {RNG_STRING(RNG_VARIANT),
+          {rng_registry, RNG_REGISTRY_SIZE},
+          {extras, sizeof(extras) / sizeof(extras[0])}};
+}
@@ -0,0 +1,43 @@
+#ifndef GENERATORS_H
+#define GENERATORS_H
+
+// The tables of generators timed by rng.cpp. generators.cpp is compiled
+// once per kernel variant, each time for a different instruction-set level
+// (baseline x64, AES-NI, AVX2, AVX-512, VAES): the generators that need an
+// instruction set are only in the variants that have it, and the others
+// are compiled for it. rng.cpp asks the processor (cpuid) which variants it
+// can run and uses the best one.
+//
+// Only plain C types (rng_info, see rnginfo.h) cross from a variant to
+// rng.cpp: a variant must not share an inline function or a template with
+// the rest of the program, since the linker would keep one copy of it,
+// perhaps compiled for an instruction set that the processor lacks. Hence
+// the plain structs below, without member functions.
+
+#include <cstddef>
+#include <cstdint>
+
+#include "rnginfo.h"
+
+// an array of count generators
+struct generator_table {
+  const rng_info *entries;
+  size_t count;
+};
+
+// registry is the rng_registry of registry.h, as compiled for the variant;
+// extras are timed as well but are not ours to test (rand)
+struct generator_set {
+  const char *variant;
+  generator_table registry;
+  generator_table extras;
+};
+
+// one function per variant compiled in (see speed/CMakeLists.txt)
+generator_set generators_baseline();
+generator_set generators_aes();
+generator_set generators_avx2();
+generator_set generators_avx512();
+generator_set generators_vaes();
+
+#endif // GENERATORS_H
@@ -3,104 +3,160 @@
 #include <cstdint>
 #include <cstring>
 #include <cassert>
+#include <cerrno>
+#include <algorithm>
 #include <vector>
+#include <string>
+#include <string_view>
 #include <format>
 #include <iostream>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <barrier>
+#include <chrono>
+#include <type_traits>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 #include "counters/bench.h"
 
-#include "xorshift32.h"
-#include "pcg32.h"
+#include "generators.h"
+
+// for --jump, and to seed the threads
 #include "xorshift128plus.h"
 #include "xorshift1024star.h"
-#include "xorshift1024plus.h"
 #include "xoroshiro128plus.h"
 #include "splitmix64.h"
-#include "splitmix63.h"
+#include "pcg32.h"
 #include "pcg64.h"
 #include "lehmer64.h"
-#include "mersennetwister.h"
-#include "mitchellmoore.h"
-#include "xorshift-k4.h"
-#include "xorshift-k5.h"
-#include "widynski.h"
-#include "wyhash.h"
-#include "wyrand.h"
-#include "w1rand.h"
-#include "trivium32.h"
-#include "trivium64.h"
-#include "CG128.h"
-#include "CG64.h"
-#include "CG128-64.h"
-#include "jenkinssmall.h"
-#ifdef __AES__
-#include "aesctr.h"
-#include "aesdragontamer.h"
+
+// The kernel variants compiled into this binary (see generators.h), best
+// first. Each variant runs on a processor that has every instruction set
+// its compiler flags allow; __builtin_cpu_supports checks them with cpuid
+// (and checks that the operating system saves the AVX registers).
+#if defined(__x86_64__) || defined(__i386__)
+static bool cpu_has_aes() {
+  return __builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt") &&
+         __builtin_cpu_supports("aes") && __builtin_cpu_supports("pclmul");
+}
+
+static bool cpu_has_avx2() {
+  return cpu_has_aes() && __builtin_cpu_supports("avx") &&
+         __builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi") &&
+         __builtin_cpu_supports("bmi2") && __builtin_cpu_supports("fma");
+}
+
+static bool cpu_has_avx512() {
+  return cpu_has_avx2() && __builtin_cpu_supports("avx512f") &&
+         __builtin_cpu_supports("avx512bw") &&
+         __builtin_cpu_supports("avx512dq") &&
+         __builtin_cpu_supports("avx512vl");
+}
+
+static bool cpu_has_vaes() {
+  return cpu_has_avx512() && __builtin_cpu_supports("vaes") &&
+         __builtin_cpu_supports("avx512ifma");
+}
 #endif
 
-typedef uint32_t (*rand32fnc)(void);
-typedef uint64_t (*rand64fnc)(void);
-typedef __uint128_t (*rand128fnc)(void);
-
-static uint32_t rand_wrapper() { return (uint32_t)rand(); }
-
-struct gen32_entry { rand32fnc fn; const char *name; };
-struct gen64_entry { rand64fnc fn; const char *name; };
-struct gen128_entry { rand128fnc fn; const char *name; };
-
-gen32_entry generators32[] = {
-    {trivium32, "trivium"},
-    {xorshift_k4, "xorshift_k4"},
-    {xorshift_k5, "xorshift_k5"},
-    {mersennetwister, "mersennetwister"},
-    {mitchellmoore, "mitchellmoore"},
-    {widynski, "widynski"},
-    {xorshift32, "xorshift32"},
-    {pcg32, "pcg32"},
-    {rand_wrapper, "rand"},
+static bool cpu_has_baseline() { return true; }
+
+struct kernel_variant {
+  const char *name;
+  generator_set (*get)();
+  bool (*supported)();
 };
 
-gen64_entry generators64[] = {
-    {trivium64, "trivium64"},
-#ifdef __AES__
-    {aesdragontamer, "aesdragontamer"},
-    {aesctr, "aesctr"},
+const kernel_variant kernel_variants[] = {
+#ifdef HAVE_RNG_VARIANT_vaes
+    {"vaes", generators_vaes, cpu_has_vaes},
+#endif
+#ifdef HAVE_RNG_VARIANT_avx512
+    {"avx512", generators_avx512, cpu_has_avx512},
 #endif
-    {lehmer64, "lehmer64"},
-    {xorshift128plus, "xorshift128plus"},
-    {xoroshiro128plus, "xoroshiro128plus"},
-    {splitmix64, "splitmix64"},
-    {splitmix63, "splitmix63"},
-    {pcg64, "pcg64"},
-    {xorshift1024star, "xorshift1024star"},
-    {xorshift1024plus, "xorshift1024plus"},
-    {wyhash64, "wyhash64"},
-    {wyrand, "wyrand"},
-    {w1rand, "w1rand"},
-    {jenkinssmall, "jenkinssmall"},
-    {CG64, "CG64"},
+#ifdef HAVE_RNG_VARIANT_avx2
+    {"avx2", generators_avx2, cpu_has_avx2},
+#endif
+#ifdef HAVE_RNG_VARIANT_aes
+    {"aes", generators_aes, cpu_has_aes},
+#endif
+    {"baseline", generators_baseline, cpu_has_baseline},
 };
 
-gen128_entry generators128[] = {
-    {CG128, "CG128"},
-    {CG128_64, "CG128_64"},
+// a generator of the kernels in use, with a state of its own
+struct generator {
+  const rng_info *info;
+  void *state;
+  const char *name;
+
+  void fill(void *out, size_t n) const { info->fill(state, out, n); }
+  void populate(void *out, size_t n) const { info->populate(state, out, n); }
 };
 
-void populate32(rand32fnc f, uint32_t *answer, size_t size) {
+// the generators of the variant in use, by width, set by select_kernels
+const char *kernels = nullptr;
+std::vector<generator> generators32, generators64, generators128;
+// the registry, whose generators can have one state per thread
+std::vector<const rng_info *> threaded_generators;
+
+void add_generator(const rng_info &info) {
+  generator g{&info, rng_alloc_state(&info), info.impl};
+  assert(g.state);
+  info.seed(g.state, 12345678);
+  switch (info.bits) {
+  case 32: generators32.push_back(g); break;
+  case 64: generators64.push_back(g); break;
+  default: generators128.push_back(g); break;
+  }
+}
+
+// Uses the variant called name, or the best one the processor supports
+// when name is null. Fails if that variant is missing or unsupported.
+bool select_kernels(const char *name) {
+  for (const kernel_variant &v : kernel_variants) {
+    if (name != nullptr ? strcmp(v.name, name) != 0 : !v.supported()) continue;
+    if (!v.supported()) {
+      std::cerr << std::format("This processor cannot run the {} kernels.\n", v.name);
+      return false;
+    }
+    generator_set set = v.get();
+    kernels = set.variant;
+    for (size_t i = 0; i < set.registry.count; i++) {
+      add_generator(set.registry.entries[i]);
+      threaded_generators.push_back(&set.registry.entries[i]);
+    }
+    for (size_t i = 0; i < set.extras.count; i++)
+      add_generator(set.extras.entries[i]);
+    return true;
+  }
+  std::cerr << std::format("No {} kernels in this binary; it has:", name);
+  for (const kernel_variant &v : kernel_variants) std::cerr << " " << v.name;
+  std::cerr << "\n";
+  return false;
+}
+
+void populate32(uint32_t (*f)(void *), void *state, uint32_t *answer,
+                size_t size) {
   for (size_t i = size; i != 0; i--) {
-    answer[size - i] = f();
+    answer[size - i] = f(state);
   }
 }
 
-void populate64(rand64fnc f, uint64_t *answer, size_t size) {
+void populate64(uint64_t (*f)(void *), void *state, uint64_t *answer,
+                size_t size) {
   for (size_t i = size; i != 0; i--) {
-    answer[size - i] = f();
+    answer[size - i] = f(state);
   }
 }
 
-void populate128(rand128fnc f, __uint128_t *answer, size_t size) {
+void populate128(__uint128_t (*f)(void *), void *state, __uint128_t *answer,
+                 size_t size) {
   for (size_t i = size; i != 0; i--) {
-    answer[size - i] = f();
+    answer[size - i] = f(state);
   }
 }
 
@@ -120,9 +176,43 @@ void pretty_print(const char *name, size_t bytes,
   std::cout << "\n";
 }
 
-void run_benchmark(int size) {
+// One measurement from the default benchmark, as written by --json/--csv.
+// The cycle and instruction counts are zero when performance counters are
+// unavailable.
+struct bench_record {
+  std::string name;
+  std::string variant; // "indirect", "inlined" or "fill" (see run_benchmark)
+  std::string kernels; // the kernel variant, e.g. "avx2"
+  size_t bytes;
+  double fastest_ns, mean_ns;
+  double fastest_cycles, mean_cycles;
+  double fastest_instructions, mean_instructions;
+
+  double gbps() const { return double(bytes) / fastest_ns; }
+  double ipc() const {
+    return fastest_cycles > 0 ? fastest_instructions / fastest_cycles : 0;
+  }
+};
+
+std::vector<bench_record> records;
+
+void record(const char *name, const char *variant, size_t bytes,
+            counters::event_aggregate agg) {
+  bool counted = counters::has_performance_counters();
+  records.push_back({name, variant, kernels, bytes, agg.fastest_elapsed_ns(),
+                     agg.elapsed_ns(), counted ? agg.fastest_cycles() : 0,
+                     counted ? agg.cycles() : 0,
+                     counted ? agg.fastest_instructions() : 0,
+                     counted ? agg.instructions() : 0});
+}
+
+void run_benchmark(size_t size) {
   std::cout << std::format("Generating {} bytes of random numbers\n", size);
   std::cout << "Time reported per byte.\n";
+  std::cout << "Each generator is timed three times: through a function pointer\n";
+  std::cout << "called once per value; with a loop compiled with the generator, so\n";
+  std::cout << "that it is inlined (inlined); with its bulk fill function, which may\n";
+  std::cout << "use another algorithm, e.g. SIMD lanes (fill).\n";
   std::cout << std::format("We store values to an array of size = {} kB.\n\n", size / 1024);
 
   void *buf = malloc(size);
@@ -131,43 +221,686 @@ void run_benchmark(int size) {
 
   std::cout << "32-bit generators:\n";
   for (auto &g : generators32) {
-    auto fn = g.fn;
+    auto fn = g.info->next.next32;
     auto results = counters::bench([&]() {
-      populate32(fn, (uint32_t *)buf, size / sizeof(uint32_t));
+      populate32(fn, g.state, (uint32_t *)buf, size / sizeof(uint32_t));
     });
     pretty_print(g.name, size, results);
+    record(g.name, "indirect", size, results);
+    results = counters::bench([&]() { g.populate((uint32_t *)buf, size / sizeof(uint32_t)); });
+    pretty_print(std::format("{} (inlined)", g.name).c_str(), size, results);
+    record(g.name, "inlined", size, results);
+    results = counters::bench([&]() { g.fill((uint32_t *)buf, size / sizeof(uint32_t)); });
+    pretty_print(std::format("{} (fill)", g.name).c_str(), size, results);
+    record(g.name, "fill", size, results);
   }
 
   std::cout << "\n64-bit generators:\n";
   for (auto &g : generators64) {
-    auto fn = g.fn;
+    auto fn = g.info->next.next64;
     auto results = counters::bench([&]() {
-      populate64(fn, (uint64_t *)buf, size / sizeof(uint64_t));
+      populate64(fn, g.state, (uint64_t *)buf, size / sizeof(uint64_t));
     });
     pretty_print(g.name, size, results);
+    record(g.name, "indirect", size, results);
+    results = counters::bench([&]() { g.populate((uint64_t *)buf, size / sizeof(uint64_t)); });
+    pretty_print(std::format("{} (inlined)", g.name).c_str(), size, results);
+    record(g.name, "inlined", size, results);
+    results = counters::bench([&]() { g.fill((uint64_t *)buf, size / sizeof(uint64_t)); });
+    pretty_print(std::format("{} (fill)", g.name).c_str(), size, results);
+    record(g.name, "fill", size, results);
   }
 
   std::cout << "\n128-bit generators:\n";
   for (auto &g : generators128) {
-    auto fn = g.fn;
+    auto fn = g.info->next.next128;
     auto results = counters::bench([&]() {
-      populate128(fn, (__uint128_t *)buf, size / sizeof(__uint128_t));
+      populate128(fn, g.state, (__uint128_t *)buf, size / sizeof(__uint128_t));
     });
     pretty_print(g.name, size, results);
+    record(g.name, "indirect", size, results);
+    results = counters::bench([&]() { g.populate((__uint128_t *)buf, size / sizeof(__uint128_t)); });
+    pretty_print(std::format("{} (inlined)", g.name).c_str(), size, results);
+    record(g.name, "inlined", size, results);
+    results = counters::bench([&]() { g.fill((__uint128_t *)buf, size / sizeof(__uint128_t)); });
+    pretty_print(std::format("{} (fill)", g.name).c_str(), size, results);
+    record(g.name, "fill", size, results);
+  }
+
+  free(buf);
+  std::cout << "\n";
+}
+
+// Sizes used by --sweep when no list is given: from well inside L1 to well
+// past the last-level cache, so that the store bandwidth of each level shows.
+const size_t default_sweep_sizes[] = {
+    size_t(4) << 10,  size_t(16) << 10, size_t(64) << 10,
+    size_t(256) << 10, size_t(1) << 20, size_t(4) << 20,
+    size_t(16) << 20, size_t(64) << 20, size_t(256) << 20,
+};
+
+// one line of the sweep tables: a name and one measurement per size
+struct sweep_row {
+  std::string name;
+  std::vector<counters::event_aggregate> results;
+};
+
+std::string format_size(size_t bytes) {
+  if (bytes % (size_t(1) << 30) == 0) return std::format("{}G", bytes >> 30);
+  if (bytes % (size_t(1) << 20) == 0) return std::format("{}M", bytes >> 20);
+  if (bytes % (size_t(1) << 10) == 0) return std::format("{}K", bytes >> 10);
+  return std::format("{}", bytes);
+}
+
+// parses a comma-separated list such as "4K,1M,2G" (binary units); fails on
+// a size that does not fit in size_t
+bool parse_sizes(std::string_view list, std::vector<size_t> &sizes) {
+  while (!list.empty()) {
+    size_t comma = list.find(',');
+    std::string token(list.substr(0, comma));
+    list = (comma == std::string_view::npos) ? std::string_view()
+                                             : list.substr(comma + 1);
+    // strtoull would accept a sign, and wrap a negative value around
+    if (token.empty() || token[0] < '0' || token[0] > '9') return false;
+    char *end = nullptr;
+    errno = 0;
+    unsigned long long value = strtoull(token.c_str(), &end, 10);
+    if (errno == ERANGE || value > SIZE_MAX) return false;
+    unsigned shift = 0;
+    switch (*end) {
+    case 'k': case 'K': shift = 10; end++; break;
+    case 'm': case 'M': shift = 20; end++; break;
+    case 'g': case 'G': shift = 30; end++; break;
+    default: break;
+    }
+    if (*end != '\0' || value > (SIZE_MAX >> shift)) return false;
+    value <<= shift;
+    // every generator table must be able to fill the buffer exactly
+    if (value == 0 || value % sizeof(__uint128_t) != 0) return false;
+    sizes.push_back(size_t(value));
+  }
+  return !sizes.empty();
+}
+
+void print_sweep_table(const char *title, const std::vector<size_t> &sizes,
+                       const std::vector<sweep_row> &rows, bool cycles) {
+  std::cout << std::format("{:<40} :", title);
+  for (size_t size : sizes) std::cout << std::format(" {:>7}", format_size(size));
+  std::cout << "\n";
+  for (const sweep_row &row : rows) {
+    std::cout << std::format("{:<40} :", row.name);
+    for (size_t i = 0; i < sizes.size(); i++) {
+      const counters::event_aggregate &agg = row.results[i];
+      double value = cycles ? agg.fastest_cycles() / double(sizes[i])
+                            : double(sizes[i]) / agg.fastest_elapsed_ns();
+      std::cout << std::format(" {:7.2f}", value);
+    }
+    std::cout << "\n";
+  }
+  std::cout << "\n";
+}
+
+// Runs the bulk fill of every generator over each buffer size. Small
+// buffers stay in L1 and measure the generator; large ones spill to the
+// outer caches and to DRAM, where the store bandwidth eventually becomes the
+// bottleneck. The memset row gives that bound for each size.
+void run_sweep(const std::vector<size_t> &sizes) {
+  std::cout << "Sweeping buffer sizes:";
+  for (size_t size : sizes) std::cout << " " << format_size(size);
+  std::cout << "\n\n";
+
+  size_t max_size = 0;
+  for (size_t size : sizes) max_size = std::max(max_size, size);
+  void *buf = malloc(max_size);
+  assert(buf);
+  memset(buf, 0, max_size); // fault the pages in before timing anything
+
+  std::vector<sweep_row> rows;
+  rows.push_back({"memset", {}});
+  for (auto &g : generators32) rows.push_back({g.name, {}});
+  for (auto &g : generators64) rows.push_back({g.name, {}});
+  for (auto &g : generators128) rows.push_back({g.name, {}});
+
+  for (size_t size : sizes) {
+    size_t r = 0;
+    rows[r++].results.push_back(counters::bench([&]() {
+      memset(buf, 0xAA, size);
+    }));
+    for (auto &g : generators32) {
+      rows[r++].results.push_back(counters::bench([&]() {
+        g.fill((uint32_t *)buf, size / sizeof(uint32_t));
+      }));
+    }
+    for (auto &g : generators64) {
+      rows[r++].results.push_back(counters::bench([&]() {
+        g.fill((uint64_t *)buf, size / sizeof(uint64_t));
+      }));
+    }
+    for (auto &g : generators128) {
+      rows[r++].results.push_back(counters::bench([&]() {
+        g.fill((__uint128_t *)buf, size / sizeof(__uint128_t));
+      }));
+    }
+  }
+  free(buf);
+
+  print_sweep_table("GB/s", sizes, rows, false);
+  if (counters::has_performance_counters()) {
+    print_sweep_table("cycles/byte", sizes, rows, true);
+  }
+}
+
+
+// pins the calling thread to one logical CPU (Linux only)
+static void pin_to_cpu(unsigned cpu) {
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+  (void)cpu;
+#endif
+}
+
+// Runs the generator on `threads` threads at once, each with its own state
+// and its own buffer, and returns the aggregate throughput in GB/s (best
+// of a few trials). Timing starts once every thread is ready.
+double run_threads(const rng_info *info, unsigned threads, size_t bytes,
+                   bool pin) {
+  const size_t rounds = std::max<size_t>(1, (size_t(64) << 20) / bytes);
+  double best = 0;
+  for (int trial = 0; trial < 3; trial++) {
+    std::barrier<> start(threads + 1);
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; t++) {
+      workers.emplace_back([=, &start]() {
+        if (pin) pin_to_cpu(t % std::thread::hardware_concurrency());
+        // allocated by the thread itself so that its pages are local to it
+        void *buf = aligned_alloc(64, bytes);
+        void *state = rng_alloc_state(info);
+        assert(buf && state);
+        info->seed(state, splitmix64_stateless(12345678, t));
+        const size_t n = bytes * 8 / info->bits;
+        info->fill(state, buf, n); // touches the pages of buf
+        start.arrive_and_wait();
+        for (size_t r = 0; r < rounds; r++) info->fill(state, buf, n);
+        rng_free_state(state);
+        free(buf);
+      });
+    }
+    start.arrive_and_wait();
+    auto begin = std::chrono::steady_clock::now();
+    for (std::thread &w : workers) w.join();
+    auto end = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(end - begin).count();
+    best = std::max(best, double(bytes) * rounds * threads / ns);
+  }
+  return best;
+}
+
+void print_matrix(const char *title, const std::vector<std::string> &columns,
+                  const std::vector<std::string> &names,
+                  const std::vector<std::vector<double>> &values) {
+  std::cout << std::format("{:<40} :", title);
+  for (const std::string &c : columns) std::cout << std::format(" {:>7}", c);
+  std::cout << "\n";
+  for (size_t r = 0; r < names.size(); r++) {
+    std::cout << std::format("{:<40} :", names[r]);
+    for (double v : values[r]) std::cout << std::format(" {:7.2f}", v);
+    std::cout << "\n";
+  }
+  std::cout << "\n";
+}
+
+// Scaling from one thread up to max_threads (powers of two, then
+// max_threads itself). Efficiency is the aggregate throughput divided by
+// the single-thread throughput times the number of threads: it drops when
+// threads compete for memory bandwidth or for shared execution units.
+void run_scaling(unsigned max_threads, const std::vector<size_t> &sizes, bool pin) {
+  std::vector<unsigned> counts;
+  for (unsigned t = 1; t < max_threads; t *= 2) counts.push_back(t);
+  counts.push_back(max_threads);
+  std::vector<std::string> columns;
+  for (unsigned t : counts) columns.push_back(std::format("{}", t));
+  std::vector<std::string> names;
+  for (const rng_info *info : threaded_generators) names.push_back(info->impl);
+
+  for (size_t bytes : sizes) {
+    std::cout << std::format("Each thread fills its own buffer of {} bytes{}.\n\n",
+                             bytes, pin ? " (threads pinned to cores)" : "");
+    std::vector<std::vector<double>> speed, efficiency;
+    for (const rng_info *info : threaded_generators) {
+      std::vector<double> row, eff;
+      for (unsigned t : counts) {
+        row.push_back(run_threads(info, t, bytes, pin));
+        eff.push_back(100 * row.back() / (t * row.front()));
+      }
+      speed.push_back(row);
+      efficiency.push_back(eff);
+    }
+    print_matrix("aggregate GB/s, by number of threads", columns, names, speed);
+    print_matrix("scaling efficiency (%)", columns, names, efficiency);
+  }
+}
+
+// Lets no later instruction start before `value` has been computed. On x64,
+// lfence waits for all prior instructions to complete; on 64-bit ARM, the
+// dsb/isb pair plays the same role.
+static inline void serialize_on(uint64_t value) {
+#if defined(__x86_64__) || defined(__i386__)
+  asm volatile("lfence" : : "r"(value) : "memory");
+#elif defined(__aarch64__)
+  asm volatile("dsb ish\n\tisb" : : "r"(value) : "memory");
+#else
+  asm volatile("" : : "r"(value) : "memory");
+#endif
+}
+
+// Dependent chain: each output is folded into an accumulator, and the next
+// call cannot begin until that accumulator is known. The processor can no
+// longer overlap successive calls, so the time per call is the latency from
+// the call to a usable value, as in code that branches on the value or uses
+// it as an address right away.
+template <typename T>
+uint64_t chain(T (*f)(void *), void *state, size_t count) {
+  uint64_t acc = 0;
+  for (size_t i = 0; i < count; i++) {
+    T x = f(state);
+    acc ^= uint64_t(x);
+    if constexpr (sizeof(T) > sizeof(uint64_t)) acc ^= uint64_t(x >> 64);
+    serialize_on(acc);
+  }
+  return acc;
+}
+
+// measures the cost of the chain itself (call, fold and fence)
+static uint64_t zero_generator(void *) { return 0; }
+
+volatile uint64_t chain_sink;
+
+void latency_print(const char *name, size_t count,
+                   counters::event_aggregate throughput,
+                   counters::event_aggregate latency) {
+  std::cout << std::format("{:<40} : ", name);
+  std::cout << std::format(" {:6.2f} ns/call ", throughput.fastest_elapsed_ns() / double(count));
+  if (counters::has_performance_counters()) {
+    std::cout << std::format(" {:6.2f} c/call ", throughput.fastest_cycles() / double(count));
+  }
+  std::cout << " | ";
+  std::cout << std::format(" {:6.2f} ns/call ", latency.fastest_elapsed_ns() / double(count));
+  if (counters::has_performance_counters()) {
+    std::cout << std::format(" {:6.2f} c/call ", latency.fastest_cycles() / double(count));
   }
+  std::cout << "\n";
+}
+
+// the next function of the generator, whose values have type T
+template <typename T> T (*next_fn(const rng_info *info))(void *) {
+  if constexpr (std::is_same_v<T, uint32_t>) return info->next.next32;
+  else if constexpr (std::is_same_v<T, uint64_t>) return info->next.next64;
+  else return info->next.next128;
+}
+
+template <typename T>
+void latency_table(const std::vector<generator> &generators, void *buf,
+                   size_t count) {
+  for (auto &g : generators) {
+    auto fn = next_fn<T>(g.info);
+    void *state = g.state;
+    auto throughput = counters::bench([&]() {
+      for (size_t i = 0; i < count; i++) ((T *)buf)[i] = fn(state);
+    });
+    auto latency = counters::bench([&]() { chain_sink = chain(fn, state, count); });
+    latency_print(g.name, count, throughput, latency);
+  }
+}
 
+// Throughput (independent calls, as in the default mode) next to latency
+// (dependent calls) for every generator, both per call.
+void run_latency() {
+  const size_t count = 512;
+  void *buf = malloc(count * sizeof(__uint128_t));
+  assert(buf);
+  std::cout << std::format("Calling each generator {} times; time reported per call.\n", count);
+  std::cout << "Left: throughput (independent calls). Right: latency (each call waits for the previous value).\n\n";
+
+  auto overhead = counters::bench([&]() { chain_sink = chain(zero_generator, nullptr, count); });
+  std::cout << std::format("The chain itself (call and fence) accounts for {:.2f} ns/call of the latency.\n",
+                           overhead.fastest_elapsed_ns() / double(count));
+
+  std::cout << "\n32-bit generators:\n";
+  latency_table<uint32_t>(generators32, buf, count);
+  std::cout << "\n64-bit generators:\n";
+  latency_table<uint64_t>(generators64, buf, count);
+  std::cout << "\n128-bit generators:\n";
+  latency_table<__uint128_t>(generators128, buf, count);
   free(buf);
   std::cout << "\n";
 }
 
-int main() {
+// A jump costs as many steps of the generator as the state has bits, plus
+// the accumulation of the state on every set bit of the jump polynomial.
+// split(n) is n - 1 jumps.
+template <typename State>
+void jump_print(const char *name, void (*seed_fn)(State *, uint64_t),
+                void (*jump_fn)(State *),
+                void (*split_fn)(const State *, State *, size_t),
+                size_t streams) {
+  State state;
+  seed_fn(&state, 12345678);
+  auto jump = counters::bench([&]() { jump_fn(&state); });
+  std::vector<State> out(streams);
+  auto split = counters::bench([&]() { split_fn(&state, out.data(), streams); });
+  std::cout << std::format("{:<40} : ", name);
+  std::cout << std::format(" {:9.1f} ns/jump ", jump.fastest_elapsed_ns());
+  if (counters::has_performance_counters()) {
+    std::cout << std::format(" {:9.1f} c/jump ", jump.fastest_cycles());
+  }
+  std::cout << std::format(" | {:9.3f} ms/split({}) ", split.fastest_elapsed_ns() / 1e6, streams);
   std::cout << "\n";
+}
+
+// the cost of advancing an LCG by delta grows with the number of bits of delta
+template <typename State, typename Delta>
+void advance_print(const char *name, void (*seed_fn)(State *, uint64_t),
+                   void (*advance_fn)(State *, Delta), Delta delta) {
+  State state;
+  seed_fn(&state, 12345678);
+  auto advance = counters::bench([&]() { advance_fn(&state, delta); });
+  std::cout << std::format("{:<40} : ", name);
+  std::cout << std::format(" {:9.1f} ns/advance ", advance.fastest_elapsed_ns());
+  if (counters::has_performance_counters()) {
+    std::cout << std::format(" {:9.1f} c/advance ", advance.fastest_cycles());
+  }
+  std::cout << "\n";
+}
+
+void run_jump() {
+  const size_t streams = 1000;
+  std::cout << "Cost of jumping ahead, and of splitting one state into non-overlapping streams.\n";
+  std::cout << "The LCG-based generators advance by an arbitrary number of steps.\n\n";
+  jump_print<xoroshiro128plus_state>("xoroshiro128plus (2^64)", xoroshiro128plus_seed_r,
+             xoroshiro128plus_jump_r, xoroshiro128plus_split_r, streams);
+  jump_print<xorshift128plus_key_t>("xorshift128plus (2^64)", xorshift128plus_seed_r,
+             xorshift128plus_jump_r, xorshift128plus_split_r, streams);
+  jump_print<xorshift1024star_state>("xorshift1024star (2^512)", xorshift1024star_seed_r,
+             xorshift1024star_jump_r, xorshift1024star_split_r, streams);
+  advance_print<pcg32_random_t, uint64_t>("pcg32 (2^63 - 1)", pcg32_seed_r,
+                pcg32_advance_r, UINT64_MAX >> 1);
+  advance_print<pcg64_random_t, pcg128_t>("pcg64 (2^127 - 1)", pcg64_seed_r,
+                pcg64_advance_r, ~pcg128_t(0) >> 1);
+  advance_print<__uint128_t, __uint128_t>("lehmer64 (2^125 - 1)", lehmer64_seed_r,
+                lehmer64_advance_r, ~__uint128_t(0) >> 3);
+  std::cout << "\n";
+}
+
+std::string json_escape(const std::string &str) {
+  std::string out;
+  for (char c : str) {
+    if (c == '"' || c == '\\') out += '\\';
+    out += c;
+  }
+  return out;
+}
+
+// JSON array with one object per line, readable by load_json below
+bool write_json(const char *filename) {
+  std::ofstream out(filename);
+  out << "[\n";
+  for (size_t i = 0; i < records.size(); i++) {
+    const bench_record &r = records[i];
+    out << std::format("  {{\"name\": \"{}\", \"variant\": \"{}\", \"kernels\": \"{}\", \"bytes\": {}, "
+                       "\"fastest_ns\": {:.3f}, \"mean_ns\": {:.3f}, "
+                       "\"fastest_cycles\": {:.1f}, \"mean_cycles\": {:.1f}, "
+                       "\"fastest_instructions\": {:.1f}, \"mean_instructions\": {:.1f}, "
+                       "\"ipc\": {:.3f}, \"gbps\": {:.4f}}}{}\n",
+                       json_escape(r.name), r.variant, r.kernels, r.bytes, r.fastest_ns,
+                       r.mean_ns, r.fastest_cycles, r.mean_cycles,
+                       r.fastest_instructions, r.mean_instructions, r.ipc(),
+                       r.gbps(), i + 1 < records.size() ? "," : "");
+  }
+  out << "]\n";
+  return bool(out);
+}
+
+bool write_csv(const char *filename) {
+  std::ofstream out(filename);
+  out << "name,variant,kernels,bytes,fastest_ns,mean_ns,fastest_cycles,mean_cycles,"
+         "fastest_instructions,mean_instructions,ipc,gbps\n";
+  for (const bench_record &r : records) {
+    out << std::format("{},{},{},{},{:.3f},{:.3f},{:.1f},{:.1f},{:.1f},{:.1f},{:.3f},{:.4f}\n",
+                       r.name, r.variant, r.kernels, r.bytes, r.fastest_ns, r.mean_ns,
+                       r.fastest_cycles, r.mean_cycles, r.fastest_instructions,
+                       r.mean_instructions, r.ipc(), r.gbps());
+  }
+  return bool(out);
+}
+
+// Reads back a file written by write_json. This is not a general JSON
+// parser: it expects a list of flat objects with string and number values.
+bool load_json(const char *filename, std::vector<bench_record> &loaded) {
+  std::ifstream in(filename);
+  if (!in) return false;
+  std::stringstream ss;
+  ss << in.rdbuf();
+  const std::string text = ss.str();
+  size_t pos = 0;
+  while ((pos = text.find('{', pos)) != std::string::npos) {
+    size_t end = text.find('}', pos);
+    if (end == std::string::npos) return false;
+    bench_record r{};
+    std::string_view object(text.data() + pos + 1, end - pos - 1);
+    while (!object.empty()) {
+      size_t k1 = object.find('"');
+      if (k1 == std::string_view::npos) break;
+      size_t k2 = object.find('"', k1 + 1);
+      size_t colon = object.find(':', k2);
+      if (k2 == std::string_view::npos || colon == std::string_view::npos) return false;
+      std::string key(object.substr(k1 + 1, k2 - k1 - 1));
+      object.remove_prefix(colon + 1);
+      while (!object.empty() && object.front() == ' ') object.remove_prefix(1);
+      std::string value;
+      if (!object.empty() && object.front() == '"') {
+        size_t close = object.find('"', 1);
+        if (close == std::string_view::npos) return false;
+        value = std::string(object.substr(1, close - 1));
+        object.remove_prefix(close + 1);
+      } else {
+        size_t comma = object.find(',');
+        value = std::string(object.substr(0, comma));
+        object.remove_prefix(comma == std::string_view::npos ? object.size() : comma);
+      }
+      if (!object.empty() && object.front() == ',') object.remove_prefix(1);
+      if (key == "name") r.name = value;
+      else if (key == "variant") r.variant = value;
+      else if (key == "kernels") r.kernels = value;
+      else if (key == "bytes") r.bytes = strtoull(value.c_str(), nullptr, 10);
+      else if (key == "fastest_ns") r.fastest_ns = strtod(value.c_str(), nullptr);
+      else if (key == "mean_ns") r.mean_ns = strtod(value.c_str(), nullptr);
+    }
+    if (r.name.empty() || r.bytes == 0 || !(r.fastest_ns > 0)) return false;
+    loaded.push_back(r);
+    pos = end + 1;
+  }
+  return true;
+}
+
+// Flags the generators whose throughput dropped by more than threshold
+// percent relative to the baseline, and those of the baseline that this run
+// did not time. Returns the number of both.
+size_t compare_to_baseline(const std::vector<bench_record> &baseline,
+                           double threshold) {
+  size_t regressions = 0;
+  std::cout << std::format("Comparison with the baseline (threshold: {:.1f}% slower):\n", threshold);
+  if (!baseline.empty() && !baseline[0].kernels.empty() &&
+      baseline[0].kernels != kernels) {
+    std::cout << std::format("The baseline ran the {} kernels, this run the {} kernels.\n",
+                             baseline[0].kernels, kernels);
+  }
+  for (const bench_record &r : records) {
+    const bench_record *b = nullptr;
+    for (const bench_record &candidate : baseline) {
+      if (candidate.name == r.name && candidate.variant == r.variant &&
+          candidate.bytes == r.bytes) {
+        b = &candidate;
+      }
+    }
+    std::string label = std::format("{} ({})", r.name, r.variant);
+    if (b == nullptr) {
+      std::cout << std::format("{:<40} :  not in baseline\n", label);
+      continue;
+    }
+    double change = 100 * (r.gbps() / b->gbps() - 1);
+    bool regressed = change < -threshold;
+    regressions += regressed;
+    std::cout << std::format("{:<40} : {:6.2f} GB/s -> {:6.2f} GB/s  {:+6.1f}%{}\n",
+                             label, b->gbps(), r.gbps(), change,
+                             regressed ? "  REGRESSION" : "");
+  }
+  size_t missing = 0;
+  for (const bench_record &b : baseline) {
+    bool found = false;
+    for (const bench_record &r : records) {
+      found = found || (r.name == b.name && r.variant == b.variant && r.bytes == b.bytes);
+    }
+    if (!found) {
+      missing++;
+      std::cout << std::format("{:<40} :  MISSING from this run\n",
+                               std::format("{} ({})", b.name, b.variant));
+    }
+  }
+  std::cout << std::format("{} regression(s), {} missing result(s) found.\n\n",
+                           regressions, missing);
+  return regressions + missing;
+}
+
+void print_usage(const char *command) {
+  std::cout << std::format("Usage: {} [--sweep] [--latency] [--jump] [--threads [N]] [--pin] [--sizes LIST] [--kernels NAME]\n", command);
+  std::cout << "  (no option)    time every generator on a 4 kB buffer\n";
+  std::cout << "  --latency      time every generator in a dependent chain of calls\n";
+  std::cout << "  --jump         time the jump-ahead, split and advance functions\n";
+  std::cout << "  --sweep        time every generator over a range of buffer sizes\n";
+  std::cout << "  --threads [N]  measure scaling on 1 to N threads (default: all cores)\n";
+  std::cout << "  --pin          pin each thread to its own core (with --threads)\n";
+  std::cout << "  --sizes LIST   comma-separated buffer sizes, e.g. 4K,1M,1G\n";
+  std::cout << "  --json FILE    also write the default benchmark results as JSON\n";
+  std::cout << "  --csv FILE     also write the default benchmark results as CSV\n";
+  std::cout << "  --compare FILE compare the default benchmark with a JSON baseline\n";
+  std::cout << "  --threshold P  regression threshold for --compare, in percent (default: 10)\n";
+  std::cout << "  --kernels NAME use these kernels instead of the best supported:";
+  for (const kernel_variant &v : kernel_variants) std::cout << " " << v.name;
+  std::cout << "\n";
+}
+
+int main(int argc, char **argv) {
+  bool sweep = false;
+  bool latency = false;
+  bool jump = false;
+  bool pin = false;
+  unsigned threads = 0;
+  const char *json_file = nullptr;
+  const char *csv_file = nullptr;
+  const char *baseline_file = nullptr;
+  const char *kernels_name = nullptr;
+  double threshold = 10;
+  std::vector<size_t> sizes;
+  for (int i = 1; i < argc; i++) {
+    std::string_view arg(argv[i]);
+    if (arg == "--sweep") {
+      sweep = true;
+    } else if (arg == "--latency") {
+      latency = true;
+    } else if (arg == "--jump") {
+      jump = true;
+    } else if (arg == "--threads") {
+      threads = std::max(1u, std::thread::hardware_concurrency());
+      if (i + 1 < argc && argv[i + 1][0] >= '1' && argv[i + 1][0] <= '9') {
+        threads = unsigned(atoi(argv[++i]));
+      }
+    } else if (arg == "--json" && i + 1 < argc) {
+      json_file = argv[++i];
+    } else if (arg == "--csv" && i + 1 < argc) {
+      csv_file = argv[++i];
+    } else if (arg == "--compare" && i + 1 < argc) {
+      baseline_file = argv[++i];
+    } else if (arg == "--threshold" && i + 1 < argc) {
+      char *end;
+      threshold = strtod(argv[++i], &end);
+      if (end == argv[i] || *end != '\0' || !(threshold >= 0)) {
+        std::cerr << std::format("Invalid --threshold {} (a percentage, e.g. 10)\n", argv[i]);
+        return EXIT_FAILURE;
+      }
+    } else if (arg == "--kernels" && i + 1 < argc) {
+      kernels_name = argv[++i];
+    } else if (arg == "--pin") {
+      pin = true;
+    } else if (arg == "--sizes" && i + 1 < argc) {
+      if (!parse_sizes(argv[++i], sizes)) {
+        std::cerr << std::format("Invalid size list: {} (sizes must be multiples of 16 bytes that fit in size_t)\n", argv[i]);
+        return EXIT_FAILURE;
+      }
+    } else if (arg == "--help" || arg == "-h") {
+      print_usage(argv[0]);
+      return EXIT_SUCCESS;
+    } else {
+      print_usage(argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+  // the records only describe the default benchmark
+  bool default_benchmark =
+      !latency && !jump && threads == 0 && !sweep && sizes.empty();
+  if (!default_benchmark &&
+      (json_file != nullptr || csv_file != nullptr || baseline_file != nullptr)) {
+    std::cerr << "--json, --csv and --compare only apply to the default benchmark, "
+                 "not to --latency, --jump, --threads, --sweep or --sizes.\n";
+    return EXIT_FAILURE;
+  }
+  if (!select_kernels(kernels_name)) return EXIT_FAILURE;
+  std::cout << "\n";
+  std::cout << std::format("Kernels: {}{}\n", kernels,
+                           kernels_name != nullptr ? " (--kernels)" : "");
   if (counters::has_performance_counters()) {
     std::cout << "Performance counters are available.\n";
   } else {
     std::cout << "Performance counters are unavailable. Only timing will be reported.\n";
     std::cout << "You may be able to get counters by running as root (sudo).\n";
   }
-  run_benchmark(4096);
+  if (latency) {
+    run_latency();
+  } else if (jump) {
+    run_jump();
+  } else if (threads > 0) {
+    if (sizes.empty()) sizes.push_back(4096);
+    run_scaling(threads, sizes, pin);
+  } else if (sweep || !sizes.empty()) {
+    if (sizes.empty()) {
+      sizes.assign(std::begin(default_sweep_sizes), std::end(default_sweep_sizes));
+    }
+    run_sweep(sizes);
+  } else {
+    std::vector<bench_record> baseline;
+    if (baseline_file != nullptr && !load_json(baseline_file, baseline)) {
+      std::cerr << std::format("Could not read the baseline {}\n", baseline_file);
+      return EXIT_FAILURE;
+    }
+    if (baseline_file != nullptr && baseline.empty()) {
+      std::cerr << std::format("The baseline {} has no results\n", baseline_file);
+      return EXIT_FAILURE;
+    }
+    run_benchmark(4096);
+    if (json_file != nullptr && !write_json(json_file)) {
+      std::cerr << std::format("Could not write {}\n", json_file);
+      return EXIT_FAILURE;
+    }
+    if (csv_file != nullptr && !write_csv(csv_file)) {
+      std::cerr << std::format("Could not write {}\n", csv_file);
+      return EXIT_FAILURE;
+    }
+    if (baseline_file != nullptr && compare_to_baseline(baseline, threshold) > 0) {
+      return EXIT_FAILURE;
+    }
+  }
   return EXIT_SUCCESS;
 }
@@ -2,12 +2,19 @@
 SCRIPTDIR="$(cd "$(dirname "$0")" && pwd)"
 cd "$SCRIPTDIR"
 
+# --resume: go on from the checkpoints of the runs that were stopped, and
+# skip those that are done; otherwise every run starts over
+resume=0
+if [ "$1" == "--resume" ]; then
+    resume=1
+    shift
+fi
 if [ $# -eq 0 ]; then
-    echo "No arguments provided"
+    echo "Usage: $0 [--resume] GENERATOR [-H]"
     exit 1
 fi
 wc="-b" #big crush
-t=$@ # this is the command
+t=$@ # the generator and its flags
 
 # we use four seeds including the default seed
 declare -a seeds=('' '-S 987654 ' ' -S 848432 ' '  -S 412451 ')
@@ -20,11 +27,23 @@ for SEEDCMD in "${seeds[@]}"; do
      echo "--- using seed flag: " $SEEDCMD
      thiscommand=$t" "$SEEDCMD" "$order" "$wc
      echo $thiscommand
-     wf=$(echo $thiscommand | sed 's/ //g')
+     wf=$(echo test$thiscommand | sed 's/ //g')
      filelog=$wf.log
-     echo "# RUNNING" $thiscommand  "Outputting result to " $filelog
-    ./$thiscommand  > $filelog
-    CMDRESULT=$?
+     # with --resume, a run that was stopped goes on from its checkpoint and
+     # a run that is done (its log has the summary) is not run again
+     checkpoint=$wf.ckpt
+     if [ $resume == 1 ] && [ -f $checkpoint ]; then
+       echo "# RESUMING" $thiscommand  "Outputting result to " $filelog
+       ./testu01 --gen $thiscommand --checkpoint $checkpoint --resume >> $filelog
+       CMDRESULT=$?
+     elif [ $resume == 1 ] && grep -qs "Summary results" $filelog; then
+       echo "# DONE" $thiscommand  "see " $filelog
+       CMDRESULT=0
+     else
+       echo "# RUNNING" $thiscommand  "Outputting result to " $filelog
+       ./testu01 --gen $thiscommand --checkpoint $checkpoint > $filelog
+       CMDRESULT=$?
+     fi
     if [ $CMDRESULT == 0 ]; then
       grep -s "All tests were passed" $filelog > /dev/null
       RESULT=$?
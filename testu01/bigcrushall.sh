@@ -2,7 +2,13 @@
 SCRIPTDIR="$(cd "$(dirname "$0")" && pwd)"
 cd "$SCRIPTDIR"
 
+# --resume is passed on to bigcrush.sh
+resume=""
+if [ "$1" == "--resume" ]; then
+    resume="--resume"
+fi
+
 . ./testlist.sh
 for t in "${commands[@]}"; do
-   ./bigcrush.sh $t
+   ./bigcrush.sh $resume $t
 done # for t in "${commands[@]}"; do
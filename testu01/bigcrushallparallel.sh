@@ -5,5 +5,11 @@
 SCRIPTDIR="$(cd "$(dirname "$0")" && pwd)"
 cd "$SCRIPTDIR"
 
+# --resume is passed on to bigcrush.sh
+resume=""
+if [ "$1" == "--resume" ]; then
+    resume="--resume "
+fi
+
 . ./testlist.sh
-printf "./bigcrush.sh %s\\0" "${commands[@]}" | xargs -0 -n1 -P`getconf _NPROCESSORS_ONLN` sh -c
+printf "./bigcrush.sh $resume%s\\0" "${commands[@]}" | xargs -0 -n1 -P`getconf _NPROCESSORS_ONLN` sh -c
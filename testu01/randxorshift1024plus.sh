@@ -2,7 +2,7 @@
 SCRIPTDIR="$(cd "$(dirname "$0")" && pwd)"
 cd "$SCRIPTDIR"
 wc="-b" #big crush
-t="testxorshift1024plus" # this is the command
+gen="xorshift1024plus" # the generator
 
 i="0"
 
@@ -10,13 +10,13 @@ while [ $i -lt 100 ]
 do
     SEEDCMD="-S "$RANDOM
      order="-z"
-     thiscommand=$t" "$SEEDCMD" "$order" "$wc
+     thiscommand=$gen" "$SEEDCMD" "$order" "$wc
      echo $thiscommand
-     wf=$(echo $thiscommand | sed 's/ //g')
+     wf=$(echo test$thiscommand | sed 's/ //g')
      filelog=$wf.log
      echo "# test $i out of 100 "
      echo "# RUNNING" $thiscommand  "Outputting result to " $filelog
-    ./$thiscommand  > ./longresults/$filelog
+    ./testu01 --gen $thiscommand  > ./longresults/$filelog
     echo
     i=$[$i+1]
 done
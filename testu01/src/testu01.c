@@ -0,0 +1,533 @@
+#define _DEFAULT_SOURCE
+#define _BSD_SOURCE
+#define _XOPEN_SOURCE 10000
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <string.h>
+#include "TestU01.h"
+#include "gofw.h"
+#include "num.h"
+#include "util64bits32bits.h"
+#include "registry.h"
+
+// Runs a TestU01 battery on one generator of the registry (--gen NAME).
+// TestU01 asks for one value at a time, so we hand them out from a buffer
+// that the bulk fill of the generator refills. A 32-bit generator gives
+// its words as the low bits of 64-bit values; a 128-bit generator gives
+// each word as two 64-bit values, the low half first.
+#define THISRNG_BUFFER_SIZE 512
+
+static const rng_info *thisrng_info;
+static void *thisrng_state;
+static __attribute__((aligned(16))) uint64_t thisrng_buffer[THISRNG_BUFFER_SIZE];
+static uint32_t thisrng_buffer32[THISRNG_BUFFER_SIZE];
+static size_t thisrng_offset = THISRNG_BUFFER_SIZE;
+
+static void thisrng_fill(void) {
+  if (thisrng_info->bits == 32) {
+    thisrng_info->fill(thisrng_state, thisrng_buffer32, THISRNG_BUFFER_SIZE);
+    for (size_t k = 0; k < THISRNG_BUFFER_SIZE; k++)
+      thisrng_buffer[k] = thisrng_buffer32[k];
+  } else {
+    thisrng_info->fill(thisrng_state, thisrng_buffer,
+                       THISRNG_BUFFER_SIZE * 64 / thisrng_info->bits);
+  }
+}
+
+static inline uint64_t thisrng(void) {
+  if (thisrng_offset == THISRNG_BUFFER_SIZE) {
+    thisrng_fill();
+    thisrng_offset = 0;
+  }
+  return thisrng_buffer[thisrng_offset++];
+}
+
+static unsigned int rng_lsb(void) { return lsb64(thisrng()); }
+static unsigned int rng_lsb_reverse(void) { return bytereverse32(lsb64(thisrng())); }
+static unsigned int rng_lsb_bitreverse(void) { return bitreverse32(lsb64(thisrng())); }
+
+static unsigned int rng_msb(void) { return msb64(thisrng()); }
+static unsigned int rng_msb_reverse(void) { return bytereverse32(msb64(thisrng())); }
+static unsigned int rng_msb_bitreverse(void) { return bitreverse32(msb64(thisrng())); }
+
+
+#define number_of_rng 6
+unsigned int (*our_rng[number_of_rng])(void) = {rng_lsb, rng_lsb_reverse, rng_lsb_bitreverse, rng_msb, rng_msb_reverse, rng_msb_bitreverse};
+const char *our_name[number_of_rng] = {" lsb 32-bits ",
+                                       " lsb 32-bits (byte reverse) ",
+                                       " lsb 32-bits (bit reverse) ",
+                                       " msb 32-bits ",
+                                       " msb 32-bits (byte reverse) ",
+                                       " msb 32-bits (bit reverse) ",};
+
+// Checkpoints (--checkpoint FILE). A battery is a sequence of tests that
+// read the generator one after the other, so we run it one test at a time
+// (bbattery_Repeat*) and, after each test, save what we need to go on:
+// the state of the generator, the values of the buffer not yet handed
+// out, and the p-values so far. The tests draw the same values as they
+// would in one call to the battery, and the summary at the end has the
+// format of TestU01's, so that bigcrush.sh and summarize.pl can read it.
+enum { SMALLCRUSH, CRUSH, BIGCRUSH, LINEARCOMP };
+
+typedef struct {
+  const char *name;
+  int tests;
+  void (*repeat)(unif01_Gen *gen, int rep[]);
+} battery;
+
+static const battery batteries[] = {
+    [SMALLCRUSH] = {"SmallCrush", 10, bbattery_RepeatSmallCrush},
+    [CRUSH] = {"Crush", 96, bbattery_RepeatCrush},
+    [BIGCRUSH] = {"BigCrush", 106, bbattery_RepeatBigCrush},
+};
+
+#define MAX_STATISTICS 256
+#define NAME_SIZE 64
+
+typedef struct {
+  char impl[NAME_SIZE];
+  int z;
+  uint64_t seed;
+  char battery[NAME_SIZE];
+  char version[NAME_SIZE];
+  int next_test; // 1 to tests + 1
+  double cpu_seconds;
+  int statistics;
+  int test[MAX_STATISTICS];
+  double pval[MAX_STATISTICS];
+  char name[MAX_STATISTICS][NAME_SIZE];
+} checkpoint;
+
+static void write_hex(FILE *f, const char *key, const void *data, size_t size) {
+  fprintf(f, "%s ", key);
+  for (size_t i = 0; i < size; i++) fprintf(f, "%02x", ((const unsigned char *)data)[i]);
+  fprintf(f, "\n");
+}
+
+static int read_hex(const char *hex, void *data, size_t size) {
+  for (size_t i = 0; i < size; i++) {
+    unsigned int byte;
+    if (sscanf(hex + 2 * i, "%2x", &byte) != 1) return 0;
+    ((unsigned char *)data)[i] = (unsigned char)byte;
+  }
+  return hex[2 * size] == '\n' || hex[2 * size] == '\0';
+}
+
+// Writes FILE.tmp, then renames it: a kill leaves the last checkpoint whole.
+static int save_checkpoint(const char *filename, const checkpoint *ck) {
+  char *tmpname = malloc(strlen(filename) + 5);
+  sprintf(tmpname, "%s.tmp", filename);
+  FILE *f = fopen(tmpname, "w");
+  if (f == NULL) {
+    perror(tmpname);
+    free(tmpname);
+    return 0;
+  }
+  fprintf(f, "impl %s\n", ck->impl);
+  fprintf(f, "z %d\n", ck->z);
+  fprintf(f, "seed %llu\n", (unsigned long long)ck->seed);
+  fprintf(f, "battery %s\n", ck->battery);
+  fprintf(f, "version %s\n", ck->version);
+  fprintf(f, "next_test %d\n", ck->next_test);
+  fprintf(f, "cpu_seconds %.17g\n", ck->cpu_seconds);
+  fprintf(f, "offset %zu\n", thisrng_offset);
+  write_hex(f, "state", thisrng_state, thisrng_info->state_size);
+  write_hex(f, "buffer", thisrng_buffer, sizeof(thisrng_buffer));
+  for (int j = 0; j < ck->statistics; j++)
+    fprintf(f, "pvalue %d %.17g %s\n", ck->test[j], ck->pval[j], ck->name[j]);
+  int ok = fflush(f) == 0 && fsync(fileno(f)) == 0;
+  ok = (fclose(f) == 0) && ok && rename(tmpname, filename) == 0;
+  if (!ok) perror(filename);
+  free(tmpname);
+  return ok;
+}
+
+// Restores the generator and fills ck; 0 if the file is damaged or is of
+// another generator.
+static int load_checkpoint(const char *filename, checkpoint *ck) {
+  FILE *f = fopen(filename, "r");
+  if (f == NULL) return 0;
+  size_t linesize = 2 * sizeof(thisrng_buffer) + 2 * thisrng_info->state_size + 64;
+  char *line = malloc(linesize);
+  int have_state = 0, have_buffer = 0, ok = 1;
+  unsigned long long seed;
+  memset(ck, 0, sizeof(*ck));
+  while (ok && fgets(line, (int)linesize, f) != NULL) {
+    char *value = strchr(line, ' ');
+    if (value == NULL) continue;
+    *value++ = '\0';
+    value[strcspn(value, "\n")] = '\0';
+    if (!strcmp(line, "impl")) {
+      snprintf(ck->impl, NAME_SIZE, "%s", value);
+    } else if (!strcmp(line, "z")) {
+      ck->z = atoi(value);
+    } else if (!strcmp(line, "seed")) {
+      ok = sscanf(value, "%llu", &seed) == 1;
+      ck->seed = seed;
+    } else if (!strcmp(line, "battery")) {
+      snprintf(ck->battery, NAME_SIZE, "%s", value);
+    } else if (!strcmp(line, "version")) {
+      snprintf(ck->version, NAME_SIZE, "%s", value);
+    } else if (!strcmp(line, "next_test")) {
+      ck->next_test = atoi(value);
+    } else if (!strcmp(line, "cpu_seconds")) {
+      ck->cpu_seconds = strtod(value, NULL);
+    } else if (!strcmp(line, "offset")) {
+      thisrng_offset = strtoull(value, NULL, 10);
+      ok = thisrng_offset <= THISRNG_BUFFER_SIZE;
+    } else if (!strcmp(line, "state")) {
+      // a state of another implementation may not even have the same size
+      ok = have_state = !strcmp(ck->impl, thisrng_info->impl) &&
+                              read_hex(value, thisrng_state, thisrng_info->state_size);
+    } else if (!strcmp(line, "buffer")) {
+      ok = have_buffer = read_hex(value, thisrng_buffer, sizeof(thisrng_buffer));
+    } else if (!strcmp(line, "pvalue") && ck->statistics < MAX_STATISTICS) {
+      int j = ck->statistics++, n = 0;
+      ok = sscanf(value, "%d %lg %n", &ck->test[j], &ck->pval[j], &n) == 2;
+      snprintf(ck->name[j], NAME_SIZE, "%s", value + n);
+    }
+  }
+  free(line);
+  fclose(f);
+  return ok && have_state && have_buffer && ck->next_test >= 1;
+}
+
+// The output of bbattery_Repeat* for one test, without the summary of that
+// one test (and without the banner of the battery unless keep_banner).
+// The version of TestU01 comes from the banner.
+static void run_test(const battery *bat, unif01_Gen *gen, int test,
+                     int keep_banner, checkpoint *ck) {
+  static int rep[MAX_STATISTICS];
+  memset(rep, 0, sizeof(rep));
+  rep[test] = 1;
+  fflush(stdout);
+  FILE *out = tmpfile();
+  if (out == NULL) { // we keep all of the output
+    bat->repeat(gen, rep);
+    return;
+  }
+  int saved = dup(STDOUT_FILENO);
+  dup2(fileno(out), STDOUT_FILENO);
+  bat->repeat(gen, rep);
+  fflush(stdout);
+  dup2(saved, STDOUT_FILENO);
+  close(saved);
+  rewind(out);
+  char line[1024];
+  int banner_lines = 0;
+  while (fgets(line, sizeof(line), out) != NULL) {
+    if (!strncmp(line, "========= Summary results", 25)) break;
+    if (banner_lines < 4 && (banner_lines > 0 || !strncmp(line, "xxxxxxxx", 8))) {
+      const char *version = strstr(line, "Version: ");
+      if (version != NULL) {
+        snprintf(ck->version, NAME_SIZE, "%s", version + 9);
+        ck->version[strcspn(ck->version, "\n")] = '\0';
+      }
+      banner_lines++;
+      if (!keep_banner) continue;
+    }
+    fputs(line, stdout);
+  }
+  fclose(out);
+}
+
+// as TestU01 writes a p-value in its summaries
+static void write_pvalue(double p) {
+  if (p < gofw_Suspectp) {
+    gofw_Writep0(p);
+  } else if (p >= 1.0 - gofw_Epsilonp1) {
+    printf(" 1 - eps1");
+  } else if (p >= 1.0 - 1.0e-4) {
+    printf(" 1 - ");
+    num_WriteD(1.0 - p, 7, 2, 2);
+  } else if (p >= 1.0 - 1.0e-2) {
+    printf("  %.4f ", p);
+  } else {
+    printf("   %.2f", p);
+  }
+}
+
+// the summary of TestU01's batteries, for the tests of the checkpoint
+static void write_summary(const checkpoint *ck, const char *genname) {
+  printf("\n========= Summary results of %s =========\n\n", ck->battery);
+  printf(" Version:          %s\n", ck->version);
+  printf(" Generator:        %s", genname);
+  printf("\n Number of statistics:  %1d\n", ck->statistics);
+  long seconds = (long)ck->cpu_seconds;
+  printf(" Total CPU time:   %02ld:%02ld:%02ld.%02ld", seconds / 3600, seconds / 60 % 60,
+         seconds % 60, (long)(100.0 * (ck->cpu_seconds - (double)seconds)));
+  int suspect = 0;
+  for (int j = 0; j < ck->statistics; j++)
+    if (ck->pval[j] < gofw_Suspectp || ck->pval[j] > 1.0 - gofw_Suspectp) suspect++;
+  if (suspect == 0) {
+    printf("\n\n All tests were passed\n\n\n\n");
+    return;
+  }
+  if (gofw_Suspectp >= 0.01)
+    printf("\n The following tests gave p-values outside [%.4g, %.2f]", gofw_Suspectp,
+           1.0 - gofw_Suspectp);
+  else if (gofw_Suspectp >= 0.0001)
+    printf("\n The following tests gave p-values outside [%.4g, %.4f]", gofw_Suspectp,
+           1.0 - gofw_Suspectp);
+  else if (gofw_Suspectp >= 0.000001)
+    printf("\n The following tests gave p-values outside [%.4g, %.6f]", gofw_Suspectp,
+           1.0 - gofw_Suspectp);
+  else
+    printf("\n The following tests gave p-values outside [%.4g, %.14f]", gofw_Suspectp,
+           1.0 - gofw_Suspectp);
+  printf(":\n (eps  means a value < %6.1e)", gofw_Epsilonp);
+  printf(":\n (eps1 means a value < %6.1e)", gofw_Epsilonp1);
+  printf(":\n\n       Test                          p-value\n");
+  printf(" ----------------------------------------------\n");
+  for (int j = 0; j < ck->statistics; j++) {
+    if (ck->pval[j] >= gofw_Suspectp && ck->pval[j] <= 1.0 - gofw_Suspectp) continue;
+    printf(" %2d ", ck->test[j]);
+    printf(" %-30s", ck->name[j]);
+    write_pvalue(ck->pval[j]);
+    printf("\n");
+  }
+  printf(" ----------------------------------------------\n");
+  if (suspect < ck->statistics - 1) printf(" All other tests were passed\n");
+  printf("\n\n\n");
+}
+
+// Runs the battery from the checkpoint in filename (if resume and there is
+// one) or from the start, saving a checkpoint after every test; the file
+// is removed once the summary is out.
+static int run_checkpointed(const battery *bat, unif01_Gen *gen, const char *filename,
+                            int resume, int z, uint64_t seedvalue) {
+  checkpoint *ck = malloc(sizeof(checkpoint));
+  if (resume && access(filename, F_OK) == 0) {
+    if (!load_checkpoint(filename, ck)) {
+      fprintf(stderr, "Cannot resume from %s: it is damaged, or of another generator.\n",
+              filename);
+      free(ck);
+      return EXIT_FAILURE;
+    }
+    if (strcmp(ck->impl, thisrng_info->impl) || ck->z != z || ck->seed != seedvalue ||
+        strcmp(ck->battery, bat->name)) {
+      fprintf(stderr, "%s is a checkpoint of %s (z = %d, seed %llu, %s), not of this run.\n",
+              filename, ck->impl, ck->z, (unsigned long long)ck->seed, ck->battery);
+      free(ck);
+      return EXIT_FAILURE;
+    }
+    printf("==resuming %s at test %d from %s\n", bat->name, ck->next_test, filename);
+  } else {
+    if (resume) fprintf(stderr, "No checkpoint in %s: starting from the first test.\n", filename);
+    memset(ck, 0, sizeof(*ck));
+    snprintf(ck->impl, NAME_SIZE, "%s", thisrng_info->impl);
+    ck->z = z;
+    ck->seed = seedvalue;
+    snprintf(ck->battery, NAME_SIZE, "%s", bat->name);
+    ck->next_test = 1;
+  }
+  while (ck->next_test <= bat->tests) {
+    clock_t start = clock();
+    run_test(bat, gen, ck->next_test, ck->next_test == 1, ck);
+    ck->cpu_seconds += (double)(clock() - start) / CLOCKS_PER_SEC;
+    for (int j = 0; j < bbattery_NTests && ck->statistics < MAX_STATISTICS; j++) {
+      int k = ck->statistics++;
+      ck->test[k] = ck->next_test;
+      ck->pval[k] = bbattery_pVal[j];
+      snprintf(ck->name[k], NAME_SIZE, "%s", bbattery_TestNames[j]);
+    }
+    ck->next_test++;
+    if (!save_checkpoint(filename, ck)) {
+      free(ck);
+      return EXIT_FAILURE;
+    }
+  }
+  write_summary(ck, gen->name);
+  fflush(stdout);
+  remove(filename);
+  free(ck);
+  return EXIT_SUCCESS;
+}
+
+void printusage(const char *command) {
+  printf(" %s --gen NAME : the generator to test (see --list)", command);
+  ;
+  printf(" %s --list : list the generators, with their width in bits", command);
+  ;
+  printf(" %s -s : small crush", command);
+  ;
+  printf(" %s -c : crush", command);
+  ;
+  printf(" %s -b : big crush", command);
+  ;
+  printf(" %s -l : linear complexity", command);
+  ;
+
+  printf(" %s : proceed until failure", command);
+  ;
+  printf(" The -r flag reverses the bytes.");
+  ;
+  printf(" The -R and the -z flags reverse the bits (they are synonymous).");
+  ;
+  printf(" The -H flag select to most signficant 32 bits (as opposed to the least significant).");
+  ;
+  printf(" The -S flag allows you to pass a seed (e.g., -S 42132).");
+  ;
+  printf(" With --checkpoint FILE, -s, -c and -b save their progress to FILE after each test;");
+  ;
+  printf(" --resume goes on from there.");
+  ;
+
+}
+
+char *concat(const char *s1, const char *s2) {
+  char *result = malloc(strlen(s1) + strlen(s2) + 1);
+  strcpy(result, s1);
+  strcat(result, s2);
+  return result;
+}
+
+// one line per stream: its name and its width in bits
+void printlist(void) {
+  for (size_t i = 0; i < RNG_REGISTRY_SIZE; i++) {
+    const rng_info *info = rng_find(rng_registry[i].name);
+    if (info == &rng_registry[i]) printf("%s %u\n", info->name, info->bits);
+  }
+}
+
+int main(int argc, char **argv) {
+  static const struct option long_options[] = {
+      {"gen", required_argument, NULL, 'g'},
+      {"list", no_argument, NULL, 'L'},
+      {"help", no_argument, NULL, 'h'},
+      {"checkpoint", required_argument, NULL, 'C'},
+      {"resume", no_argument, NULL, 'U'},
+      {NULL, 0, NULL, 0}};
+  const char *genname = NULL;
+  const char *checkpointname = NULL;
+  int resume = 0;
+  uint64_t seedvalue = 12345678;
+  unif01_Gen *gen;
+  int z = 0;// selects the folding method
+
+  int use_msb = 0;
+  int testroutine = SMALLCRUSH;
+  int c;
+
+  while ((c = getopt_long(argc, argv, "g:csbhrzRHlS:", long_options, NULL)) != -1)
+    switch (c) {
+    case 'g':
+      genname = optarg;
+      break;
+    case 'L':
+      printlist();
+      return 0;
+    case 'l':
+      testroutine = LINEARCOMP;
+      break;
+    case 'S':
+      seedvalue = atoi(optarg);
+      break;
+    case 'r':
+      z = 1;
+      break;
+    case 'R':
+      z = 2;
+      break;
+    case 'z':
+      z = 2;
+      break;
+    case 's':
+      testroutine = SMALLCRUSH;
+      break;
+    case 'c':
+      testroutine = CRUSH;
+      break;
+    case 'b':
+      testroutine = BIGCRUSH;
+      break;
+    case 'H':
+      use_msb = 1;
+      break;
+    case 'C':
+      checkpointname = optarg;
+      break;
+    case 'U':
+      resume = 1;
+      break;
+    case 'h':
+      printusage(argv[0]);
+      return 0;
+    default:
+      abort();
+    }
+  if (genname == NULL) {
+    printusage(argv[0]);
+    return EXIT_FAILURE;
+  }
+  if ((checkpointname != NULL || resume) && testroutine == LINEARCOMP) {
+    fprintf(stderr, "Only the batteries (-s, -c, -b) have checkpoints.\n");
+    return EXIT_FAILURE;
+  }
+  if (resume && checkpointname == NULL) {
+    fprintf(stderr, "--resume needs --checkpoint FILE.\n");
+    return EXIT_FAILURE;
+  }
+  if (!rng_isa_supported(RNG_ISA_BUILD)) {
+    fprintf(stderr, "%s was built for instructions that this processor lacks.\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  thisrng_info = rng_find(genname);
+  if (thisrng_info == NULL) {
+    fprintf(stderr, "Unknown generator %s (see %s --list).\n", genname, argv[0]);
+    return EXIT_FAILURE;
+  }
+  thisrng_state = rng_alloc_state(thisrng_info);
+  if (thisrng_state == NULL) return EXIT_FAILURE;
+  printf("==seed: %llu \n", (unsigned long long)seedvalue);
+  thisrng_info->seed(thisrng_state, seedvalue);
+  printf("==%s \n", thisrng_info->name);
+  if(use_msb) z += 3;
+  char *tmpname = concat(thisrng_info->name, our_name[z]);
+  gen = unif01_CreateExternGenBits(tmpname, our_rng[z]);
+
+  int result = EXIT_SUCCESS;
+  if (checkpointname != NULL) {
+    result = run_checkpointed(&batteries[testroutine], gen, checkpointname, resume, z,
+                              seedvalue);
+  } else {
+    switch (testroutine) {
+    case SMALLCRUSH:
+      bbattery_SmallCrush(gen);
+      break;
+    case CRUSH:
+      bbattery_Crush(gen);
+      break;
+    case BIGCRUSH:
+      bbattery_BigCrush(gen);
+      break;
+    case LINEARCOMP:
+      // from O'Neill's
+      {
+      scomp_Res* res = scomp_CreateRes();
+      swrite_Basic = TRUE;
+      int size_array[] = {5000, 25000, 50000};
+      for (size_t k = 0; k < sizeof(size_array)/sizeof(int); k++) {
+          scomp_LinearComp(gen, res, 1, size_array[k], 0, 1);
+      }
+      scomp_DeleteRes(res);
+      fflush(stdout);
+      }
+      break;
+
+    default:
+      abort();
+    }
+  }
+
+  unif01_DeleteExternGenBits(gen);
+  free(tmpname);
+  rng_free_state(thisrng_state);
+
+
+  return result;
+}
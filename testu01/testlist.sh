@@ -1,4 +1,16 @@
 #!/usr/bin/env bash
 # Normally this script is executed in the context of another script,
-# with the "." command.
-declare -a commands=('testsplitmix64 -H' 'testsplitmix64' 'testpcg32' 'testpcg64 -H' 'testpcg64' 'testxoroshiro128plus -H' 'testxoroshiro128plus' 'testv8xorshift128plus -H' 'testv8xorshift128plus' 'testxorshift128plus -H' 'testxorshift128plus' 'testlehmer64' 'testlehmer64 -H' 'testxorshift32' 'testmersennetwister' 'testxorshift1024star' 'testxorshift1024star -H' 'testxorshift1024plus' 'testxorshift1024plus -H' 'testwyhash' 'testwyhash -H' 'testwyrand' 'testwyrand -H' );
+# with the "." command. It lists the generators of the registry (see
+# ./testu01 --list), or only those named on the command line of that
+# script, each 64-bit generator twice: its least and its most (-H)
+# significant 32 bits.
+declare -a commands=()
+while read -r gen bits; do
+  if [ $# -gt 0 ] && [[ ! " $* " =~ " $gen " ]]; then
+    continue
+  fi
+  commands+=("$gen")
+  if [ "$bits" != "32" ]; then
+    commands+=("$gen -H")
+  fi
+done < <(./testu01 --list)
@@ -0,0 +1,89 @@
+#include "lehmer64.h"
+#include "pcg32.h"
+#include "pcg64.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+////
+// advance(delta) must land where delta single steps land, and going back
+// (pcg) or jumping in two parts must agree with a single jump. Streams
+// selected by distinct ids must differ.
+#define SEED 12345678
+#define STEPS 1000
+
+static int failures = 0;
+
+static void check(const char *name, bool ok) {
+  printf("%-20s %s\n", name, ok ? "ok" : "MISMATCH");
+  if (!ok) failures++;
+}
+
+static bool pcg32_ok(void) {
+  pcg32_random_t a, b, c;
+  pcg32_seed_r(&a, SEED);
+  b = a;
+  for (uint64_t delta = 0; delta < STEPS; delta++) {
+    c = b;
+    pcg32_advance_r(&c, delta);
+    if (c.state != a.state || pcg32_r(&c) != pcg32_r(&a)) return false;
+  }
+  // back to where we started
+  pcg32_advance_r(&a, -(uint64_t)STEPS);
+  if (a.state != b.state) return false;
+  pcg32_advance_r(&a, UINT64_C(1) << 40);
+  pcg32_discard_r(&a, UINT64_C(1) << 40);
+  pcg32_advance_r(&b, UINT64_C(1) << 41);
+  if (a.state != b.state) return false;
+  pcg32_seed_stream_r(&a, SEED, 0);
+  pcg32_seed_stream_r(&b, SEED, 1);
+  return pcg32_r(&a) != pcg32_r(&b);
+}
+
+static bool pcg64_ok(void) {
+  pcg64_random_t a, b, c;
+  pcg64_seed_r(&a, SEED);
+  b = a;
+  for (uint64_t delta = 0; delta < STEPS; delta++) {
+    c = b;
+    pcg64_advance_r(&c, delta);
+    if (c.state != a.state || pcg64_r(&c) != pcg64_r(&a)) return false;
+  }
+  pcg64_advance_r(&a, -(pcg128_t)STEPS);
+  if (a.state != b.state) return false;
+  pcg64_advance_r(&a, ((pcg128_t)1) << 100);
+  pcg64_discard_r(&a, ((pcg128_t)1) << 100);
+  pcg64_advance_r(&b, ((pcg128_t)1) << 101);
+  if (a.state != b.state) return false;
+  pcg64_seed_stream_r(&a, SEED, 0);
+  pcg64_seed_stream_r(&b, SEED, 1);
+  return pcg64_r(&a) != pcg64_r(&b);
+}
+
+static bool lehmer64_ok(void) {
+  __uint128_t a, b, c;
+  lehmer64_seed_r(&a, SEED);
+  b = a;
+  for (uint64_t delta = 0; delta < STEPS; delta++) {
+    c = b;
+    lehmer64_advance_r(&c, delta);
+    if (c != a || lehmer64_r(&c) != lehmer64_r(&a)) return false;
+  }
+  a = b;
+  lehmer64_advance_r(&a, ((__uint128_t)1) << 100);
+  lehmer64_discard_r(&a, ((__uint128_t)1) << 100);
+  lehmer64_advance_r(&b, ((__uint128_t)1) << 101);
+  return a == b;
+}
+
+int main() {
+  check("pcg32", pcg32_ok());
+  check("pcg64", pcg64_ok());
+  check("lehmer64", lehmer64_ok());
+  if (failures) {
+    printf("Bug!\n");
+    return -1;
+  }
+  printf("The advance functions match repeated steps.\n");
+  return 0;
+}
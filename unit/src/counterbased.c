@@ -0,0 +1,137 @@
+#include "philox.h"
+#include "threefry.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+////
+// The block functions must match the known-answer vectors of Random123
+// (kat_vectors). The generators must give the same words whether we call
+// them, fill a buffer (SIMD), seek to a position or read a position
+// directly.
+#define COUNT 5000
+
+static int failures = 0;
+
+static void check(const char *name, bool ok) {
+  printf("%-24s %s\n", name, ok ? "ok" : "MISMATCH");
+  if (!ok) failures++;
+}
+
+static bool philox_kat(void) {
+  const uint32_t zero32[4] = {0, 0, 0, 0};
+  const uint32_t ones32[4] = {UINT32_MAX, UINT32_MAX, UINT32_MAX, UINT32_MAX};
+  const uint32_t pi32[4] = {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344};
+  const uint32_t pikey32[2] = {0xa4093822, 0x299f31d0};
+  uint32_t x[4];
+  philox4x32_block(zero32, zero32, x);
+  if (x[0] != 0x6627e8d5 || x[1] != 0xe169c58d || x[2] != 0xbc57ac4c ||
+      x[3] != 0x9b00dbd8)
+    return false;
+  philox4x32_block(ones32, ones32, x);
+  if (x[0] != 0x408f276d || x[1] != 0x41c83b0e || x[2] != 0xa20bc7c6 ||
+      x[3] != 0x6d5451fd)
+    return false;
+  philox4x32_block(pi32, pikey32, x);
+  if (x[0] != 0xd16cfe09 || x[1] != 0x94fdcceb || x[2] != 0x5001e420 ||
+      x[3] != 0x24126ea1)
+    return false;
+  const uint64_t zero64[4] = {0, 0, 0, 0};
+  const uint64_t ones64[4] = {UINT64_MAX, UINT64_MAX, UINT64_MAX, UINT64_MAX};
+  const uint64_t pi64[4] = {
+      UINT64_C(0x243f6a8885a308d3), UINT64_C(0x13198a2e03707344),
+      UINT64_C(0xa4093822299f31d0), UINT64_C(0x082efa98ec4e6c89)};
+  const uint64_t pikey64[2] = {UINT64_C(0x452821e638d01377),
+                               UINT64_C(0xbe5466cf34e90c6c)};
+  uint64_t y[4];
+  philox4x64_block(zero64, zero64, y);
+  if (y[0] != UINT64_C(0x16554d9eca36314c) || y[1] != UINT64_C(0xdb20fe9d672d0fdc) ||
+      y[2] != UINT64_C(0xd7e772cee186176b) || y[3] != UINT64_C(0x7e68b68aec7ba23b))
+    return false;
+  philox4x64_block(ones64, ones64, y);
+  if (y[0] != UINT64_C(0x87b092c3013fe90b) || y[1] != UINT64_C(0x438c3c67be8d0224) ||
+      y[2] != UINT64_C(0x9cc7d7c69cd777b6) || y[3] != UINT64_C(0xa09caebf594f0ba0))
+    return false;
+  philox4x64_block(pi64, pikey64, y);
+  return y[0] == UINT64_C(0xa528f45403e61d95) &&
+         y[1] == UINT64_C(0x38c72dbd566e9788) &&
+         y[2] == UINT64_C(0xa5a1610e72fd18b5) &&
+         y[3] == UINT64_C(0x57bd43b5e52b7fe6);
+}
+
+static bool threefry_kat(void) {
+  const uint64_t zero[4] = {0, 0, 0, 0};
+  const uint64_t ones[4] = {UINT64_MAX, UINT64_MAX, UINT64_MAX, UINT64_MAX};
+  const uint64_t pi[2] = {UINT64_C(0x243f6a8885a308d3),
+                          UINT64_C(0x13198a2e03707344)};
+  const uint64_t pikey[2] = {UINT64_C(0xa4093822299f31d0),
+                             UINT64_C(0x082efa98ec4e6c89)};
+  uint64_t y[4];
+  threefry2x64_block(zero, zero, y);
+  if (y[0] != UINT64_C(0xc2b6e3a8c2c69865) || y[1] != UINT64_C(0x6f81ed42f350084d))
+    return false;
+  threefry2x64_block(ones, ones, y);
+  if (y[0] != UINT64_C(0xe02cb7c4d95d277a) || y[1] != UINT64_C(0xd06633d0893b8b68))
+    return false;
+  threefry2x64_block(pi, pikey, y);
+  if (y[0] != UINT64_C(0x263c7d30bb0f0af1) || y[1] != UINT64_C(0x56be8361d3311526))
+    return false;
+  threefry4x64_block(zero, zero, y);
+  if (y[0] != UINT64_C(0x09218ebde6c85537) || y[1] != UINT64_C(0x55941f5266d86105) ||
+      y[2] != UINT64_C(0x4bd25e16282434dc) || y[3] != UINT64_C(0xee29ec846bd2e40b))
+    return false;
+  threefry4x64_block(ones, ones, y);
+  return y[0] == UINT64_C(0x29c24097942bba1b) &&
+         y[1] == UINT64_C(0x0371bbfb0f6f4e11) &&
+         y[2] == UINT64_C(0x3c231ffa33f83a1c) &&
+         y[3] == UINT64_C(0xcd29113fde32d168);
+}
+
+#define CHECK_STREAM(NAME)                                                     \
+  static bool NAME##_stream(uint64_t seed, uint64_t start) {                   \
+    static uint64_t expected[COUNT];                                           \
+    static uint64_t out[COUNT];                                                \
+    NAME##_state s1, s2;                                                       \
+    NAME##_seed_r(&s1, seed);                                                  \
+    NAME##_seek_r(&s1, start);                                                 \
+    s2 = s1;                                                                   \
+    for (size_t i = 0; i < COUNT; i++) expected[i] = NAME##_r(&s1);            \
+    size_t i = 0;                                                              \
+    for (size_t chunk = 1; i < COUNT; chunk = 2 * chunk + 1) {                 \
+      if (chunk > COUNT - i) chunk = COUNT - i;                                \
+      NAME##_fill_r(&s2, out + i, chunk);                                      \
+      i += chunk;                                                              \
+    }                                                                          \
+    if (memcmp(out, expected, sizeof(out)) != 0) return false;                 \
+    for (size_t k = 0; k < COUNT; k += 37) {                                   \
+      if (NAME##_at_r(&s2, start + k) != expected[k]) return false;            \
+      NAME##_seek_r(&s2, start + k);                                           \
+      if (NAME##_r(&s2) != expected[k]) return false;                          \
+    }                                                                          \
+    return true;                                                               \
+  }
+
+CHECK_STREAM(philox4x32)
+CHECK_STREAM(philox4x64)
+CHECK_STREAM(threefry2x64)
+CHECK_STREAM(threefry4x64)
+
+int main() {
+  check("philox_kat", philox_kat());
+  check("threefry_kat", threefry_kat());
+  // the second start has the low 32 bits of the philox4x32 counter wrap
+  const uint64_t starts[2] = {0, (UINT64_C(1) << 33) - 101};
+  for (int k = 0; k < 2; k++) {
+    check("philox4x32", philox4x32_stream(k, starts[k]));
+    check("philox4x64", philox4x64_stream(k, starts[k]));
+    check("threefry2x64", threefry2x64_stream(k, starts[k]));
+    check("threefry4x64", threefry4x64_stream(k, starts[k]));
+  }
+  if (failures) {
+    printf("Bug!\n");
+    return -1;
+  }
+  printf("The counter-based generators match the reference vectors.\n");
+  return 0;
+}
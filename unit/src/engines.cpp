@@ -0,0 +1,101 @@
+#include "engines.hpp"
+#include <cstdio>
+#include <random>
+#include <span>
+#include <vector>
+
+////
+// Every engine of engines.hpp must be a std::uniform_random_bit_generator,
+// discard(n) must skip the same values as n calls, and generate must write
+// the values that calls would have returned, in chunks of any size.
+#define COUNT 3000
+
+static int failures = 0;
+
+static void check(const char *name, const char *what, bool ok) {
+  std::printf("%-24s %-10s %s\n", name, what, ok ? "ok" : "MISMATCH");
+  if (!ok) failures++;
+}
+
+template <typename Engine> static void check_engine(const char *name) {
+  static_assert(std::uniform_random_bit_generator<Engine>);
+  using result_type = typename Engine::result_type;
+
+  Engine calls(12345678), fills(12345678);
+  std::vector<result_type> expected(COUNT), out(COUNT);
+  for (auto &v : expected) v = calls();
+  size_t i = 0;
+  for (size_t chunk = 1; i < COUNT; chunk = 2 * chunk + 1) {
+    if (chunk > COUNT - i) chunk = COUNT - i;
+    fills.generate(std::span<result_type>(out.data() + i, chunk));
+    i += chunk;
+  }
+  check(name, "generate", out == expected);
+
+  bool ok = true;
+  for (unsigned long long n : {0ull, 1ull, 3ull, 64ull, 1000ull, 2999ull}) {
+    Engine skipped(12345678);
+    skipped.discard(n);
+    ok = ok && skipped() == expected[n];
+  }
+  // discard after calls, which may leave values in a buffer
+  Engine mixed(12345678);
+  mixed();
+  mixed.discard(997);
+  ok = ok && mixed() == expected[998];
+  check(name, "discard", ok);
+}
+
+int main() {
+  using namespace testingrng;
+  check_engine<trivium32_engine>("trivium32");
+  check_engine<xorshift_k4_engine>("xorshift_k4");
+  check_engine<xorshift_k5_engine>("xorshift_k5");
+  check_engine<mersennetwister_engine>("mersennetwister");
+  check_engine<mitchellmoore_engine>("mitchellmoore");
+  check_engine<widynski_engine>("widynski");
+  check_engine<xorshift32_engine>("xorshift32");
+  check_engine<pcg32_engine>("pcg32");
+  check_engine<trivium64_engine>("trivium64");
+  check_engine<lehmer64_engine>("lehmer64");
+  check_engine<lehmer64x_engine>("lehmer64x");
+  check_engine<xorshift128plus_engine>("xorshift128plus");
+  check_engine<v8xorshift128plus_engine>("v8xorshift128plus");
+  check_engine<xoroshiro128plus_engine>("xoroshiro128plus");
+  check_engine<splitmix64_engine>("splitmix64");
+  check_engine<splitmix63_engine>("splitmix63");
+  check_engine<pcg64_engine>("pcg64");
+  check_engine<xorshift1024star_engine>("xorshift1024star");
+  check_engine<xorshift1024plus_engine>("xorshift1024plus");
+  check_engine<wyhash64_engine>("wyhash64");
+  check_engine<wyrand_engine>("wyrand");
+  check_engine<wyrandx_engine>("wyrandx");
+  check_engine<w1rand_engine>("w1rand");
+  check_engine<jenkinssmall_engine>("jenkinssmall");
+  check_engine<philox4x32_engine>("philox4x32");
+  check_engine<philox4x64_engine>("philox4x64");
+  check_engine<threefry2x64_engine>("threefry2x64");
+  check_engine<threefry4x64_engine>("threefry4x64");
+  check_engine<CG64_engine>("CG64");
+#ifdef __AES__
+  check_engine<aesctr_engine>("aesctr");
+  check_engine<aesdragontamer_engine>("aesdragontamer");
+#ifdef AESCTR_VAES_LANES
+  check_engine<aesctr_vaes_engine>("aesctr_vaes");
+#endif
+#ifdef AESDRAGONTAMER_VAES_LANES
+  check_engine<aesdragontamer_vaes_engine>("aesdragontamer_vaes");
+#endif
+#endif
+#ifdef __AVX2__
+  check_engine<simdxorshift128plus_engine>("simdxorshift128plus");
+  check_engine<simdxoroshiro128plus_engine>("simdxoroshiro128plus");
+  check_engine<simdtrivium64_engine>("simdtrivium64");
+#endif
+  if (failures) {
+    std::printf("Bug!\n");
+    return -1;
+  }
+  std::printf("Every engine discards and generates as it calls.\n");
+  return 0;
+}
@@ -0,0 +1,80 @@
+#include "xoroshiro128plus.h"
+#include "xorshift1024star.h"
+#include "xorshift128plus.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+////
+// We cannot run 2^64 steps, so the jumps are checked against values
+// computed independently over GF(2): the first output after a jump from
+// seed 12345678. We also check that split gives the successive jumps.
+#define SEED 12345678
+#define SPLIT 4
+
+static int failures = 0;
+
+static void check(const char *name, uint64_t got, uint64_t expected) {
+  bool ok = (got == expected);
+  printf("%-32s %s\n", name, ok ? "ok" : "MISMATCH");
+  if (!ok) failures++;
+}
+
+int main() {
+  xoroshiro128plus_state xo, xo_split[SPLIT];
+  xoroshiro128plus_seed_r(&xo, SEED);
+  xoroshiro128plus_split_r(&xo, xo_split, SPLIT);
+  xoroshiro128plus_jump_r(&xo);
+  check("xoroshiro128plus_jump", xoroshiro128plus_r(&xo),
+        UINT64_C(0xf7689abab771ba49));
+  xoroshiro128plus_seed_r(&xo, SEED);
+  xoroshiro128plus_long_jump_r(&xo);
+  check("xoroshiro128plus_long_jump", xoroshiro128plus_r(&xo),
+        UINT64_C(0xc96eaa9dc44967eb));
+  xoroshiro128plus_seed_r(&xo, SEED);
+  for (int i = 0; i < SPLIT - 1; i++) xoroshiro128plus_jump_r(&xo);
+  check("xoroshiro128plus_split", xoroshiro128plus_r(&xo_split[SPLIT - 1]),
+        xoroshiro128plus_r(&xo));
+
+  xorshift128plus_key_t xs, xs_split[SPLIT];
+  xorshift128plus_seed_r(&xs, SEED);
+  xorshift128plus_split_r(&xs, xs_split, SPLIT);
+  xorshift128plus_jump_r(&xs);
+  check("xorshift128plus_jump", xorshift128plus_r(&xs),
+        UINT64_C(0xc381569dd0132a95));
+  xorshift128plus_seed_r(&xs, SEED);
+  xorshift128plus_long_jump_r(&xs);
+  check("xorshift128plus_long_jump", xorshift128plus_r(&xs),
+        UINT64_C(0xa0e72a2ad744294a));
+  xorshift128plus_seed_r(&xs, SEED);
+  for (int i = 0; i < SPLIT - 1; i++) xorshift128plus_jump_r(&xs);
+  check("xorshift128plus_split", xorshift128plus_r(&xs_split[SPLIT - 1]),
+        xorshift128plus_r(&xs));
+
+  xorshift1024star_state st, st_split[SPLIT];
+  xorshift1024star_seed_r(&st, SEED);
+  xorshift1024star_split_r(&st, st_split, SPLIT);
+  xorshift1024star_jump_r(&st);
+  check("xorshift1024star_jump", xorshift1024star_r(&st),
+        UINT64_C(0xa8599df465158965));
+  // the jump must not depend on where we are in the circular buffer
+  xorshift1024star_seed_r(&st, SEED);
+  xorshift1024star_state moved = st;
+  for (int i = 0; i < 5; i++) xorshift1024star_r(&moved);
+  xorshift1024star_jump_r(&st);
+  for (int i = 0; i < 5; i++) xorshift1024star_r(&st);
+  xorshift1024star_jump_r(&moved);
+  check("xorshift1024star_jump_offset", xorshift1024star_r(&moved),
+        xorshift1024star_r(&st));
+  xorshift1024star_seed_r(&st, SEED);
+  for (int i = 0; i < SPLIT - 1; i++) xorshift1024star_jump_r(&st);
+  check("xorshift1024star_split", xorshift1024star_r(&st_split[SPLIT - 1]),
+        xorshift1024star_r(&st));
+
+  if (failures) {
+    printf("Bug!\n");
+    return -1;
+  }
+  printf("The jump functions match the reference values.\n");
+  return 0;
+}
@@ -0,0 +1,121 @@
+#include "CG128-64.h"
+#include "CG128.h"
+#include "CG64.h"
+#include "jenkinssmall.h"
+#include "lehmer64.h"
+#include "mersennetwister.h"
+#include "mitchellmoore.h"
+#include "pcg32.h"
+#include "pcg64.h"
+#include "splitmix63.h"
+#include "splitmix64.h"
+#include "trivium32.h"
+#include "trivium64.h"
+#include "w1rand.h"
+#include "widynski.h"
+#include "wyhash.h"
+#include "wyrand.h"
+#include "xoroshiro128plus.h"
+#include "xorshift-k4.h"
+#include "xorshift-k5.h"
+#include "xorshift1024plus.h"
+#include "xorshift1024star.h"
+#include "xorshift128plus.h"
+#include "xorshift32.h"
+#ifdef __AES__
+#include "aesctr.h"
+#include "aesdragontamer.h"
+#endif
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+////
+// Every generator has a global version (NAME_seed/NAME) and a reentrant
+// version on an explicit state (NAME_seed_r/NAME_r). Both must produce the
+// stream of the original global generator: we fold the first COUNT values
+// from SEED into a digest and compare it to the digest recorded from the
+// original code (the ANSWER argument). Two states seeded alike must also stay
+// in lockstep when their calls interleave (so no state is secretly shared).
+#define COUNT 100000
+#define SEED 12345678
+
+static int failures = 0;
+
+// FNV-style fold of a stream of values
+static uint64_t fold(uint64_t h, uint64_t v) {
+  return (h ^ v) * UINT64_C(0x100000001b3);
+}
+
+#define CHECK_WITH(NAME, STATE, SEED_GLOBAL, SEED_R, ANSWER)                   \
+  do {                                                                         \
+    STATE a, b;                                                                \
+    uint64_t global = 0, reentrant = 0;                                        \
+    bool ok = true;                                                            \
+    SEED_GLOBAL(SEED);                                                         \
+    SEED_R(&a, SEED);                                                          \
+    for (size_t i = 0; i < COUNT; i++) {                                       \
+      global = fold(global, (uint64_t)NAME());                                 \
+      reentrant = fold(reentrant, (uint64_t)NAME##_r(&a));                     \
+    }                                                                          \
+    if (global != (ANSWER) || reentrant != (ANSWER)) ok = false;               \
+    SEED_R(&a, SEED);                                                          \
+    SEED_R(&b, SEED);                                                          \
+    for (size_t i = 0; i < COUNT; i++)                                         \
+      if (NAME##_r(&a) != NAME##_r(&b)) ok = false;                            \
+    printf("%-20s %s\n", #NAME, ok ? "ok" : "MISMATCH");                      \
+    if (!ok) failures++;                                                       \
+  } while (0)
+
+#define CHECK(NAME, STATE, ANSWER)                                             \
+  CHECK_WITH(NAME, STATE, NAME##_seed, NAME##_seed_r, ANSWER)
+
+// trivium takes a sequence number on top of the seed
+static void trivium32_seed_global(uint64_t seed) { trivium32_seed(seed, 0); }
+static void trivium32_seed_state(trivium32_state *state, uint64_t seed) {
+  trivium32_seed_r(state, seed, 0);
+}
+static void trivium64_seed_global(uint64_t seed) { trivium64_seed(seed, 0); }
+static void trivium64_seed_state(trivium64_state *state, uint64_t seed) {
+  trivium64_seed_r(state, seed, 0);
+}
+
+int main() {
+  CHECK(xorshift32, unsigned int, UINT64_C(0x19d11863942e9ec0));
+  CHECK(pcg32, pcg32_random_t, UINT64_C(0x92960fd534d4ad59));
+  CHECK(mersennetwister, mersennetwister_state, UINT64_C(0xb69546f5f6fb1424));
+  CHECK(mitchellmoore, mitchellmoore_state, UINT64_C(0x7803ea346ecf3340));
+  CHECK(xorshift_k4, xorshift_k4_state, UINT64_C(0xba9505a923d2b6d2));
+  CHECK(xorshift_k5, xorshift_k5_state, UINT64_C(0xbaed6fc6753ebb29));
+  CHECK(widynski, widynski_state, UINT64_C(0x287ad93aef3dbe0e));
+  CHECK_WITH(trivium32, trivium32_state, trivium32_seed_global,
+             trivium32_seed_state, UINT64_C(0xb552ee4adc9e55e7));
+  CHECK_WITH(trivium64, trivium64_state, trivium64_seed_global,
+             trivium64_seed_state, UINT64_C(0x781dc4daf71b90f7));
+  CHECK(xorshift128plus, xorshift128plus_key_t, UINT64_C(0xc184520d383e6f63));
+  CHECK(xoroshiro128plus, xoroshiro128plus_state, UINT64_C(0xb5495d7e342731eb));
+  CHECK(xorshift1024plus, xorshift1024plus_state, UINT64_C(0xe3028d5a252542da));
+  CHECK(xorshift1024star, xorshift1024star_state, UINT64_C(0xd6dd21de79872c95));
+  CHECK(splitmix64, uint64_t, UINT64_C(0x8bfda3a8cfb5c436));
+  CHECK(splitmix63, uint64_t, UINT64_C(0x6e84bd0fccc24810));
+  CHECK(pcg64, pcg64_random_t, UINT64_C(0x09492034552e071a));
+  CHECK(lehmer64, __uint128_t, UINT64_C(0xa768657131b04019));
+  CHECK(wyhash64, uint64_t, UINT64_C(0xd26681f7bed9af71));
+  CHECK(wyrand, uint64_t, UINT64_C(0xed4763f6aa950042));
+  CHECK(w1rand, uint64_t, UINT64_C(0x4d26d7e3ddec181b));
+  CHECK_WITH(jenkinssmall, jenkinssmall_ranctx, jenkinssmall_init,
+             jenkinssmall_seed_r, UINT64_C(0xdeba82b6264ad05d));
+  CHECK(CG64, CG64_state, UINT64_C(0x1b11cf7b66cdf3a5));
+  CHECK(CG128, CG128_state, UINT64_C(0x4903472924e58dab));
+  CHECK(CG128_64, CG128_64_state, UINT64_C(0xd7c8b8da2a28a206));
+#ifdef __AES__
+  CHECK(aesctr, aesctr_state, UINT64_C(0x8944ecc140e8d88c));
+  CHECK(aesdragontamer, aesdragontamer_state, UINT64_C(0x2e1b021354da7e2a));
+#endif
+  if (failures) {
+    printf("Bug!\n");
+    return -1;
+  }
+  printf("The global and reentrant functions produce the original streams.\n");
+  return 0;
+}
@@ -0,0 +1,88 @@
+#include "registry.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+////
+// Every entry of the registry must give the same values whether we call
+// next, fill a buffer in chunks of any size, or populate it (the plain loop
+// of the speed benchmark), and the implementations of a stream (same name)
+// must agree with one another.
+#define COUNT 3000
+
+static int failures = 0;
+
+static void check(const char *name, bool ok) {
+  printf("%-24s %s\n", name, ok ? "ok" : "MISMATCH");
+  if (!ok) failures++;
+}
+
+// COUNT values, 128 bits of room each
+static __uint128_t expected[COUNT], out[COUNT], reference[COUNT];
+
+static void next_values(const rng_info *info, void *state, void *buffer) {
+  for (size_t i = 0; i < COUNT; i++) {
+    if (info->bits == 32)
+      ((uint32_t *)buffer)[i] = info->next.next32(state);
+    else if (info->bits == 64)
+      ((uint64_t *)buffer)[i] = info->next.next64(state);
+    else
+      ((__uint128_t *)buffer)[i] = info->next.next128(state);
+  }
+}
+
+static bool entry_consistent(const rng_info *info) {
+  void *s1 = rng_alloc_state(info);
+  void *s2 = rng_alloc_state(info);
+  if (s1 == NULL || s2 == NULL) return false;
+  info->seed(s1, 12345678);
+  info->seed(s2, 12345678);
+  next_values(info, s1, expected);
+  const size_t bytes = info->bits / 8;
+  size_t i = 0;
+  for (size_t chunk = 1; i < COUNT; chunk = 2 * chunk + 1) {
+    if (chunk > COUNT - i) chunk = COUNT - i;
+    info->fill(s2, (char *)out + i * bytes, chunk);
+    i += chunk;
+  }
+  bool ok = memcmp(out, expected, COUNT * bytes) == 0;
+  info->seed(s2, 12345678);
+  info->populate(s2, out, COUNT);
+  ok = ok && memcmp(out, expected, COUNT * bytes) == 0;
+  rng_free_state(s1);
+  rng_free_state(s2);
+  return ok;
+}
+
+int main() {
+  for (size_t k = 0; k < RNG_REGISTRY_SIZE; k++) {
+    const rng_info *info = &rng_registry[k];
+    if (!rng_isa_supported(info->isa)) {
+      printf("%-24s skipped (unsupported instructions)\n", info->impl);
+      continue;
+    }
+    check(info->impl, entry_consistent(info));
+    // the first supported implementation of the stream is the reference
+    const rng_info *first = rng_find(info->name);
+    if (first != info && first != NULL) {
+      void *state = rng_alloc_state(first);
+      first->seed(state, 12345678);
+      next_values(first, state, reference);
+      rng_free_state(state);
+      state = rng_alloc_state(info);
+      info->seed(state, 12345678);
+      next_values(info, state, expected);
+      rng_free_state(state);
+      char label[64];
+      snprintf(label, sizeof(label), "%s = %s", info->impl, first->impl);
+      check(label, memcmp(reference, expected, COUNT * (info->bits / 8)) == 0);
+    }
+  }
+  if (failures) {
+    printf("Bug!\n");
+    return -1;
+  }
+  printf("Every generator of the registry fills as it calls.\n");
+  return 0;
+}
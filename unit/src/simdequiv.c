@@ -0,0 +1,347 @@
+#include "lehmer64x.h"
+#include "mersennetwister.h"
+#ifdef __AES__
+#include "aesctr.h"
+#include "aesdragontamer.h"
+#endif
+#include "simdxoroshiro128plus.h"
+#include "simdxorshift128plus.h"
+#include "simdtrivium64.h"
+#include "splitmix64.h"
+#include "trivium64.h"
+#include "w1rand.h"
+#include "wyhash.h"
+#include "wyrand.h"
+#include "wyrandx.h"
+#include "xoroshiro128plus.h"
+#include "xorshift128plus.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+////
+// The vectorized generators must be nothing more than several scalar
+// generators running side by side: lane i of the interleaved stream is
+// the scalar generator seeded from the (2i)-th and (2i+1)-th outputs of
+// splitmix64. We also mix single calls with bulk fills of odd lengths, so
+// that the buffered tail is checked as well.
+//
+// The bulk fills of the counter-based generators must write exactly what
+// repeated calls would have returned, and leave the state where they would
+// have left it.
+#define STEPS 1024
+
+#define CHECK_FILL(NAME)                                                       \
+  static bool NAME##_fill_equiv(uint64_t seed) {                               \
+    uint64_t expected[STEPS];                                                  \
+    uint64_t out[STEPS];                                                       \
+    uint64_t s1 = seed;                                                        \
+    uint64_t s2 = seed;                                                        \
+    for (size_t i = 0; i < STEPS; i++) expected[i] = NAME##_r(&s1);            \
+    size_t i = 0;                                                              \
+    for (size_t chunk = 1; i < STEPS; chunk = 2 * chunk + 1) {                 \
+      if (chunk > STEPS - i) chunk = STEPS - i;                                \
+      NAME##_fill_r(&s2, out + i, chunk);                                      \
+      i += chunk;                                                              \
+    }                                                                          \
+    for (size_t k = 0; k < STEPS; k++) {                                       \
+      if (out[k] != expected[k]) return false;                                 \
+    }                                                                          \
+    return s1 == s2;                                                           \
+  }
+
+CHECK_FILL(splitmix64)
+CHECK_FILL(wyrand)
+CHECK_FILL(wyhash64)
+CHECK_FILL(w1rand)
+
+// The interleaved generators (lehmer64x, wyrandx) run 2, 4 or 8 scalar
+// generators whose states are copied out after seeding; calls and fills
+// must give their outputs in turn. The lanes must also be different
+// sequences: lanes seeded too close to one another share their low bits,
+// so no lane may match the low 32 bits of lane 0 at any step.
+#define CHECK_INTERLEAVED(NAME, SCALAR_STATE, SCALAR_R)                        \
+  static bool NAME##_lanes_equiv(uint64_t seed, size_t lanes) {                \
+    NAME##_state state;                                                        \
+    SCALAR_STATE scalar[8];                                                    \
+    uint64_t out[STEPS];                                                       \
+    NAME##_seed_r(&state, seed, lanes);                                        \
+    for (size_t j = 0; j < lanes; j++) scalar[j] = state.s[j];                 \
+    size_t i = 0;                                                              \
+    for (size_t chunk = 1; i < STEPS; chunk = 2 * chunk + 1) {                 \
+      out[i++] = NAME##_r(&state);                                             \
+      if (chunk > STEPS - i) chunk = STEPS - i;                                \
+      NAME##_fill_r(&state, out + i, chunk);                                   \
+      i += chunk;                                                              \
+    }                                                                          \
+    for (size_t k = 0; k < STEPS; k++) {                                       \
+      if (out[k] != SCALAR_R(&scalar[k % lanes])) return false;                \
+    }                                                                          \
+    for (size_t k = 0; k + lanes <= STEPS; k += lanes) {                       \
+      for (size_t j = 1; j < lanes; j++) {                                     \
+        if ((uint32_t)out[k] == (uint32_t)out[k + j]) return false;            \
+      }                                                                        \
+    }                                                                          \
+    return true;                                                               \
+  }                                                                            \
+  static bool NAME##_equiv(uint64_t seed) {                                    \
+    return NAME##_lanes_equiv(seed, 2) && NAME##_lanes_equiv(seed, 4) &&       \
+           NAME##_lanes_equiv(seed, 8);                                        \
+  }
+
+CHECK_INTERLEAVED(lehmer64x, __uint128_t, lehmer64_r)
+CHECK_INTERLEAVED(wyrandx, uint64_t, wyrand_r)
+
+// the Mersenne Twister regenerates its state with SIMD both in
+// mersennetwister_r and in mersennetwister_fill_r, so we also check it
+// against the reference MT19937 outputs for the default seed (5489): the
+// first output is 3499211612 and the 10000th is 4123659995
+static bool mersennetwister_fill_equiv(uint64_t seed) {
+  uint32_t expected[3 * STEPS];
+  uint32_t out[3 * STEPS];
+  mersennetwister_state s1;
+  mersennetwister_state s2;
+  mersennetwister_seed_r(&s1, seed);
+  mersennetwister_seed_r(&s2, seed);
+  for (size_t i = 0; i < 3 * STEPS; i++) expected[i] = mersennetwister_r(&s1);
+  size_t i = 0;
+  for (size_t chunk = 1; i < 3 * STEPS; chunk = 2 * chunk + 1) {
+    if (chunk > 3 * STEPS - i) chunk = 3 * STEPS - i;
+    mersennetwister_fill_r(&s2, out + i, chunk);
+    i += chunk;
+  }
+  for (size_t k = 0; k < 3 * STEPS; k++) {
+    if (out[k] != expected[k]) return false;
+  }
+  return mersennetwister_r(&s1) == mersennetwister_r(&s2);
+}
+
+static bool mersennetwister_reference(void) {
+  mersennetwister_state state;
+  uint32_t out[10000];
+  mersennetwister_seed_r(&state, 5489);
+  mersennetwister_fill_r(&state, out, 10000);
+  return out[0] == UINT32_C(3499211612) && out[9999] == UINT32_C(4123659995);
+}
+
+#ifdef __AES__
+// aesctr_fill_bytes_r writes a byte stream: fills of any length, mixed with
+// calls and with other unroll factors, must give the bytes of repeated
+// aesctr_r
+static bool aesctr_fill_equiv(uint64_t seed) {
+  uint64_t expected[STEPS];
+  uint8_t out[8 * STEPS];
+  aesctr_state s1;
+  aesctr_state s2;
+  aesctr_seed_r(&s1, seed);
+  aesctr_seed_r(&s2, seed);
+  for (size_t i = 0; i < STEPS; i++) expected[i] = aesctr_r(&s1);
+  size_t i = 0;
+  for (size_t chunk = 1; i + 8 <= 8 * STEPS; chunk = 2 * chunk + 1) {
+    uint64_t v = aesctr_unrolled_r(&s2, 16);
+    memcpy(out + i, &v, sizeof(v));
+    i += sizeof(v);
+    if (chunk > 8 * STEPS - i) chunk = 8 * STEPS - i;
+    if (chunk % 2) {
+      aesctr_fill_bytes_r(&s2, out + i, chunk);
+    } else {
+      aesctr_fill_unrolled_r(&s2, out + i, chunk, 8);
+    }
+    i += chunk;
+  }
+  return memcmp(out, expected, i) == 0;
+}
+#else
+static bool aesctr_fill_equiv(uint64_t seed) {
+  (void)seed;
+  return true;
+}
+#endif
+
+#ifdef AESCTR_VAES_LANES
+// the VAES versions must produce the 128-bit stream, calls and fills alike
+static bool aesctr_vaes_equiv(uint64_t seed) {
+  uint64_t expected[STEPS];
+  uint8_t out[8 * STEPS];
+  aesctr_state s1;
+  aesctr_state s2;
+  aesctr_seed_r(&s1, seed);
+  aesctr_seed_r(&s2, seed);
+  for (size_t i = 0; i < STEPS; i++) expected[i] = aesctr_r(&s1);
+  size_t i = 0;
+  for (size_t chunk = 1; i + 8 <= 8 * STEPS; chunk = 2 * chunk + 1) {
+    uint64_t v = aesctr_vaes_r(&s2);
+    memcpy(out + i, &v, sizeof(v));
+    i += sizeof(v);
+    if (chunk > 8 * STEPS - i) chunk = 8 * STEPS - i;
+    aesctr_vaes_fill_bytes_r(&s2, out + i, chunk);
+    i += chunk;
+  }
+  return memcmp(out, expected, i) == 0;
+}
+#else
+static bool aesctr_vaes_equiv(uint64_t seed) {
+  (void)seed;
+  return true;
+}
+#endif
+
+#ifdef __AES__
+// aesdragontamer_fill_r writes whole steps past the buffer
+static bool aesdragontamer_fill_equiv(uint64_t seed) {
+  uint64_t out[STEPS];
+  aesdragontamer_state s1;
+  aesdragontamer_state s2;
+  aesdragontamer_seed_r(&s1, seed);
+  aesdragontamer_seed_r(&s2, seed);
+  size_t i = 0;
+  for (size_t chunk = 1; i < STEPS; chunk = 2 * chunk + 1) {
+    out[i++] = aesdragontamer_r(&s2);
+    if (chunk > STEPS - i) chunk = STEPS - i;
+    aesdragontamer_fill_r(&s2, out + i, chunk);
+    i += chunk;
+  }
+  for (size_t k = 0; k < STEPS; k++) {
+    if (out[k] != aesdragontamer_r(&s1)) return false;
+  }
+  return true;
+}
+#else
+static bool aesdragontamer_fill_equiv(uint64_t seed) {
+  (void)seed;
+  return true;
+}
+#endif
+
+#ifdef AESDRAGONTAMER_VAES_LANES
+static bool aesdragontamer_vaes_equiv(uint64_t seed) {
+  uint64_t out[STEPS];
+  aesdragontamer_state s1;
+  aesdragontamer_state s2;
+  aesdragontamer_seed_r(&s1, seed);
+  aesdragontamer_seed_r(&s2, seed);
+  size_t i = 0;
+  for (size_t chunk = 1; i < STEPS; chunk = 2 * chunk + 1) {
+    out[i++] = aesdragontamer_vaes_r(&s2);
+    if (chunk > STEPS - i) chunk = STEPS - i;
+    aesdragontamer_vaes_fill_r(&s2, out + i, chunk);
+    i += chunk;
+  }
+  for (size_t k = 0; k < STEPS; k++) {
+    if (out[k] != aesdragontamer_r(&s1)) return false;
+  }
+  return true;
+}
+#else
+static bool aesdragontamer_vaes_equiv(uint64_t seed) {
+  (void)seed;
+  return true;
+}
+#endif
+
+static bool fills_equiv(uint64_t seed) {
+  return splitmix64_fill_equiv(seed) && wyrand_fill_equiv(seed) &&
+         wyhash64_fill_equiv(seed) && w1rand_fill_equiv(seed) &&
+         mersennetwister_fill_equiv(seed) && aesctr_fill_equiv(seed) &&
+         aesctr_vaes_equiv(seed) && aesdragontamer_fill_equiv(seed) &&
+         aesdragontamer_vaes_equiv(seed) && lehmer64x_equiv(seed) &&
+         wyrandx_equiv(seed);
+}
+
+#ifdef __AVX2__
+#define CHECK_SIMD(NAME, SCALAR_STATE, SCALAR_INIT, SCALAR_R, LANES)           \
+  static bool NAME##_equiv(uint64_t seed) {                                    \
+    NAME##_state state;                                                        \
+    SCALAR_STATE lanes[LANES];                                                 \
+    uint64_t out[STEPS * LANES];                                               \
+    uint64_t sm = seed;                                                        \
+    for (size_t i = 0; i < LANES; i++) {                                       \
+      uint64_t a = splitmix64_r(&sm);                                          \
+      uint64_t b = splitmix64_r(&sm);                                          \
+      SCALAR_INIT(&lanes[i], a, b);                                            \
+    }                                                                          \
+    NAME##_seed_r(&state, seed);                                               \
+    size_t i = 0;                                                              \
+    for (size_t chunk = 1; i < STEPS * LANES; chunk = 2 * chunk + 1) {         \
+      out[i++] = NAME##_r(&state);                                             \
+      if (chunk > STEPS * LANES - i) chunk = STEPS * LANES - i;                \
+      NAME##_fill_r(&state, out + i, chunk);                                   \
+      i += chunk;                                                              \
+    }                                                                          \
+    for (size_t k = 0; k < STEPS * LANES; k++) {                               \
+      if (out[k] != SCALAR_R(&lanes[k % LANES])) return false;                 \
+    }                                                                          \
+    return true;                                                               \
+  }
+
+static void xoroshiro_init(xoroshiro128plus_state *s, uint64_t a, uint64_t b) {
+  s->s[0] = a;
+  s->s[1] = b;
+}
+
+static void xorshift_init(xorshift128plus_key_t *k, uint64_t a, uint64_t b) {
+  xorshift128plus_init(a, b, k);
+}
+
+CHECK_SIMD(simdxoroshiro128plus, xoroshiro128plus_state, xoroshiro_init,
+           xoroshiro128plus_r, SIMDXOROSHIRO128PLUS_LANES)
+CHECK_SIMD(simdxorshift128plus, xorshift128plus_key_t, xorshift_init,
+           xorshift128plus_r, SIMDXORSHIFT128PLUS_LANES)
+
+// lane i of simdtrivium64 is trivium64 with the sequence number seq + i
+static bool simdtrivium64_equiv(uint64_t seed) {
+  simdtrivium64_state state;
+  trivium64_state lanes[SIMDTRIVIUM64_LANES];
+  uint64_t out[STEPS * SIMDTRIVIUM64_LANES];
+  const uint64_t seq = seed * seed;
+  for (size_t i = 0; i < SIMDTRIVIUM64_LANES; i++) {
+    trivium64_seed_r(&lanes[i], seed, seq + i);
+  }
+  simdtrivium64_seed_r(&state, seed, seq);
+  size_t i = 0;
+  for (size_t chunk = 1; i < STEPS * SIMDTRIVIUM64_LANES; chunk = 2 * chunk + 1) {
+    out[i++] = simdtrivium64_r(&state);
+    if (chunk > STEPS * SIMDTRIVIUM64_LANES - i) {
+      chunk = STEPS * SIMDTRIVIUM64_LANES - i;
+    }
+    simdtrivium64_fill_r(&state, out + i, chunk);
+    i += chunk;
+  }
+  for (size_t k = 0; k < STEPS * SIMDTRIVIUM64_LANES; k++) {
+    if (out[k] != trivium64_r(&lanes[k % SIMDTRIVIUM64_LANES])) return false;
+  }
+  return true;
+}
+
+int main() {
+  if (!mersennetwister_reference()) {
+    printf("Bug!\n");
+    return -1;
+  }
+  for (uint64_t seed = 0; seed < 1000; seed++) {
+    if (!simdxoroshiro128plus_equiv(seed) || !simdxorshift128plus_equiv(seed) ||
+        !simdtrivium64_equiv(seed) || !fills_equiv(seed)) {
+      printf("Bug!\n");
+      return -1;
+    }
+  }
+  printf("The SIMD generators and bulk fills match their scalar versions.\n");
+  return 0;
+}
+#else
+int main() {
+  if (!mersennetwister_reference()) {
+    printf("Bug!\n");
+    return -1;
+  }
+  for (uint64_t seed = 0; seed < 1000; seed++) {
+    if (!fills_equiv(seed)) {
+      printf("Bug!\n");
+      return -1;
+    }
+  }
+  printf("The bulk fills match their scalar versions.\n");
+  return 0;
+}
+#endif